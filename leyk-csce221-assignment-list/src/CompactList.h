@@ -0,0 +1,421 @@
+#pragma once
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <cstdint> // uint32_t
+#include <cstring> // std::memcpy
+#include <iterator> // std::bidirectional_iterator_tag
+#include <new> // placement new, ::operator new, std::bad_alloc
+#include <type_traits> // std::is_trivially_copyable, std::enable_if, std::is_convertible
+#include <utility> // std::move, std::forward
+
+/*
+    CompactList
+    -----------
+
+    A doubly linked list whose nodes all live in one contiguous array and
+    link to each other by 32-bit index instead of by pointer. Links take
+    8 bytes per node instead of 16, there is one allocation for the whole
+    list instead of one per node, and neighbouring nodes tend to share cache
+    lines.
+
+    Erased nodes go onto a free list threaded through the same array and
+    are reused before the array grows. Growing relocates the array, but
+    iterators hold an index rather than an address, so they stay valid;
+    only references and pointers to elements are invalidated.
+
+    For trivially copyable T the node array is a plain block of bytes, so
+    copying a CompactList (or growing it) is a single memcpy.
+
+    Holds at most 2^32 - 2 elements; beyond that insert throws
+    std::bad_alloc.
+
+    Example:
+    {
+        CompactList<Order> book;
+        auto it = book.insert(book.end(), order);
+        book.reserve(1 << 20);          // relocates, it is still valid
+        Order& o = *it;
+    }
+*/
+template <class T>
+class CompactList {
+    using index_type = uint32_t;
+
+    // Node 0 is the sentinel, so index 0 also ends the free list
+    static constexpr index_type nil = 0;
+    // prev of a node on the free list
+    static constexpr index_type unused = ~index_type(0);
+
+    struct Node {
+        index_type next, prev;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* data() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    template <typename pointer_type, typename reference_type>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using pointer           = pointer_type;
+        using reference         = reference_type;
+    private:
+        friend class CompactList;
+
+        CompactList* owner;
+        index_type idx;
+
+        basic_iterator(const CompactList* owner, index_type idx) noexcept
+        : owner{const_cast<CompactList*>(owner)}, idx{idx} {}
+
+    public:
+        basic_iterator() noexcept : owner{nullptr}, idx{nil} {}
+        // iterator converts to const_iterator, not the other way around
+        template <typename P, typename R,
+                  typename std::enable_if<std::is_convertible<P, pointer_type>::value, int>::type = 0>
+        basic_iterator(const basic_iterator<P, R>& other) noexcept : owner{other.owner}, idx{other.idx} {}
+
+        reference operator*() const {
+            return *owner->nodes[idx].data();
+        }
+        pointer operator->() const {
+            return owner->nodes[idx].data();
+        }
+
+        basic_iterator& operator++() {
+            idx = owner->nodes[idx].next;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+        basic_iterator& operator--() {
+            idx = owner->nodes[idx].prev;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            basic_iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        template <typename P, typename R>
+        bool operator==(const basic_iterator<P, R>& other) const noexcept {
+            return idx == other.idx && owner == other.owner;
+        }
+        template <typename P, typename R>
+        bool operator!=(const basic_iterator<P, R>& other) const noexcept {
+            return !(*this == other);
+        }
+
+        template <typename P, typename R>
+        friend class basic_iterator;
+    };
+
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+    using iterator        = basic_iterator<pointer, reference>;
+    using const_iterator  = basic_iterator<const_pointer, const_reference>;
+
+private:
+    // nullptr until the first insert or reserve, so an empty list does not
+    // allocate
+    Node* nodes;
+    // Nodes [0, used) have been handed out at least once
+    index_type used;
+    index_type cap;
+    index_type free_head;
+    size_type _size;
+
+    static constexpr size_type max_nodes = size_type(unused);
+
+    static Node* allocate(size_type count) {
+        return static_cast<Node*>(::operator new(count * sizeof(Node)));
+    }
+
+    // Moves the first used nodes into an array of new_cap nodes
+    void relocate(size_type new_cap) {
+        Node* fresh = allocate(new_cap);
+        if (used == 0) {
+            // Nothing to move yet
+        }
+        else if (std::is_trivially_copyable<T>::value) {
+            std::memcpy(static_cast<void*>(fresh), nodes, used * sizeof(Node));
+        }
+        else {
+            for (index_type i = 0; i < used; i++) {
+                fresh[i].next = nodes[i].next;
+                fresh[i].prev = nodes[i].prev;
+                if (i != nil && nodes[i].prev != unused) {
+                    new (fresh[i].storage) T(std::move(*nodes[i].data()));
+                    nodes[i].data()->~T();
+                }
+            }
+        }
+        ::operator delete(nodes);
+        nodes = fresh;
+        cap = static_cast<index_type>(new_cap);
+        if (used == 0) {
+            nodes[nil].next = nodes[nil].prev = nil;
+            used = 1;
+        }
+    }
+    // Whether the next take_node has to relocate the array
+    bool full() const noexcept {
+        return free_head == nil && used == cap;
+    }
+
+    index_type take_node() {
+        if (free_head != nil) {
+            index_type idx = free_head;
+            free_head = nodes[idx].next;
+            return idx;
+        }
+        if (used == cap) {
+            if (cap == max_nodes) {
+                throw std::bad_alloc();
+            }
+            relocate(cap < 2 ? 4 : cap > max_nodes / 2 ? max_nodes : size_type(cap) * 2);
+        }
+        return used++;
+    }
+    void give_node(index_type idx) noexcept {
+        nodes[idx].prev = unused;
+        nodes[idx].next = free_head;
+        free_head = idx;
+    }
+
+    template <class Arg>
+    iterator emplace(const_iterator pos, Arg&& value) {
+        if (full()) {
+            // value may be an element of this list, which is about to move
+            T copy(std::forward<Arg>(value));
+            return construct(pos, take_node(), std::move(copy));
+        }
+        return construct(pos, take_node(), std::forward<Arg>(value));
+    }
+    template <class Arg>
+    iterator construct(const_iterator pos, index_type idx, Arg&& value) {
+        try {
+            new (nodes[idx].storage) T(std::forward<Arg>(value));
+        }
+        catch (...) {
+            give_node(idx);
+            throw;
+        }
+        index_type next = pos.idx;
+        index_type prev = nodes[next].prev;
+        nodes[idx].next = next;
+        nodes[idx].prev = prev;
+        nodes[prev].next = idx;
+        nodes[next].prev = idx;
+        _size++;
+        return iterator(this, idx);
+    }
+
+    void reset() noexcept {
+        if (nodes != nullptr) {
+            nodes[nil].next = nodes[nil].prev = nil;
+            used = 1;
+        }
+        free_head = nil;
+        _size = 0;
+    }
+    // Leaves other empty, without an array
+    void steal(CompactList& other) noexcept {
+        nodes = other.nodes;
+        used = other.used;
+        cap = other.cap;
+        free_head = other.free_head;
+        _size = other._size;
+        other.nodes = nullptr;
+        other.used = other.cap = 0;
+        other.free_head = nil;
+        other._size = 0;
+    }
+
+    void destroy() noexcept {
+        if (nodes != nullptr && !std::is_trivially_destructible<T>::value) {
+            for (index_type i = nodes[nil].next; i != nil; i = nodes[i].next) {
+                nodes[i].data()->~T();
+            }
+        }
+    }
+
+public:
+    CompactList() noexcept : nodes(nullptr), used(0), cap(0), free_head(nil), _size(0) {}
+    CompactList(size_type count, const T& value) : CompactList() {
+        reserve(count);
+        for (size_type i = 0; i < count; i++) {
+            push_back(value);
+        }
+    }
+    explicit CompactList(size_type count) : CompactList() {
+        reserve(count);
+        for (size_type i = 0; i < count; i++) {
+            push_back(T());
+        }
+    }
+    // Keeps the same node layout, so iterators into other map to this copy
+    // by index, and trivially copyable elements are copied in one memcpy
+    CompactList(const CompactList& other)
+    : nodes(other.nodes == nullptr ? nullptr : allocate(other.used)), used(other.used), cap(other.used),
+      free_head(other.free_head), _size(other._size) {
+        if (nodes == nullptr) {
+            return;
+        }
+        if (std::is_trivially_copyable<T>::value) {
+            std::memcpy(static_cast<void*>(nodes), other.nodes, used * sizeof(Node));
+            return;
+        }
+        index_type i = 0;
+        try {
+            for (; i < used; i++) {
+                nodes[i].next = other.nodes[i].next;
+                nodes[i].prev = other.nodes[i].prev;
+                if (i != nil && nodes[i].prev != unused) {
+                    new (nodes[i].storage) T(*other.nodes[i].data());
+                }
+            }
+        }
+        catch (...) {
+            for (index_type j = 1; j < i; j++) {
+                if (nodes[j].prev != unused) {
+                    nodes[j].data()->~T();
+                }
+            }
+            ::operator delete(nodes);
+            throw;
+        }
+    }
+    CompactList(CompactList&& other) noexcept : CompactList() {
+        steal(other);
+    }
+    ~CompactList() {
+        destroy();
+        ::operator delete(nodes);
+    }
+
+    CompactList& operator=(const CompactList& other) {
+        if (this != &other) {
+            CompactList copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    CompactList& operator=(CompactList&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        destroy();
+        ::operator delete(nodes);
+        steal(other);
+        return *this;
+    }
+
+    reference front() {
+        return *nodes[nodes[nil].next].data();
+    }
+    const_reference front() const {
+        return *nodes[nodes[nil].next].data();
+    }
+    reference back() {
+        return *nodes[nodes[nil].prev].data();
+    }
+    const_reference back() const {
+        return *nodes[nodes[nil].prev].data();
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, nodes == nullptr ? nil : nodes[nil].next);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, nodes == nullptr ? nil : nodes[nil].next);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    iterator end() noexcept {
+        return iterator(this, nil);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, nil);
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+    size_type size() const noexcept {
+        return _size;
+    }
+    // Elements that fit before the array has to grow
+    size_type capacity() const noexcept {
+        return cap == 0 ? 0 : cap - 1;
+    }
+    void reserve(size_type new_cap) {
+        if (new_cap >= max_nodes) {
+            throw std::bad_alloc();
+        }
+        if (new_cap + 1 > cap) {
+            relocate(new_cap + 1);
+        }
+    }
+
+    // Keeps the array
+    void clear() noexcept {
+        destroy();
+        reset();
+    }
+
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+    iterator erase(const_iterator pos) {
+        index_type idx = pos.idx;
+        index_type next = nodes[idx].next;
+        index_type prev = nodes[idx].prev;
+        nodes[prev].next = next;
+        nodes[next].prev = prev;
+        nodes[idx].data()->~T();
+        give_node(idx);
+        _size--;
+        return iterator(this, next);
+    }
+
+    void push_back(const T& value) {
+        insert(end(), value);
+    }
+    void push_back(T&& value) {
+        insert(end(), std::move(value));
+    }
+    void pop_back() {
+        erase(--end());
+    }
+    void push_front(const T& value) {
+        insert(begin(), value);
+    }
+    void push_front(T&& value) {
+        insert(begin(), std::move(value));
+    }
+    void pop_front() {
+        erase(begin());
+    }
+};
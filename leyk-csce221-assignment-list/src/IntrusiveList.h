@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <iterator> // std::bidirectional_iterator_tag
+#include <type_traits> // std::enable_if, std::is_convertible
+
+/*
+    IntrusiveList
+    -------------
+
+    A doubly linked list of objects that carry their own links. Each object
+    embeds a ListHook per list it can belong to, and IntrusiveList<T, &T::hook>
+    threads objects together through that hook. The list never allocates,
+    copies or destroys an element: it only links objects that live elsewhere
+    (in a pool, a Vector, on the stack), so insert and erase are a handful
+    of pointer writes.
+
+    An object with two hooks can be in two lists at once, and because the
+    links are in the object, it can be unlinked in O(1) from a pointer
+    alone with hook.unlink() or IntrusiveList::remove. A hook that is
+    destroyed while linked unlinks itself, and copying an object does not
+    copy its links.
+
+    Since an object can leave a list without the list knowing, the list
+    keeps no element count: size() walks the list, empty() is O(1).
+
+    Example:
+    {
+        struct Page {
+            int id;
+            ListHook lru;       // position in the LRU order
+            ListHook dirty;     // membership in the dirty set
+        };
+
+        IntrusiveList<Page, &Page::lru> lru;
+        IntrusiveList<Page, &Page::dirty> dirty;
+
+        lru.push_front(page);       // no allocation
+        dirty.push_back(page);      // same object, second list
+        page.lru.unlink();          // O(1), the list is not needed
+    }
+*/
+class ListHook {
+    template <class T, ListHook T::*Hook>
+    friend class IntrusiveList;
+
+    ListHook *next, *prev;
+
+    void link_before(ListHook* pos) noexcept {
+        next = pos;
+        prev = pos->prev;
+        prev->next = this;
+        pos->prev = this;
+    }
+
+public:
+    ListHook() noexcept : next(nullptr), prev(nullptr) {}
+    // Links belong to the object's place in a list, not to its value
+    ListHook(const ListHook&) noexcept : ListHook() {}
+    ListHook& operator=(const ListHook&) noexcept {
+        return *this;
+    }
+    ~ListHook() {
+        unlink();
+    }
+
+    bool is_linked() const noexcept {
+        return next != nullptr;
+    }
+    // Removes the object from whatever list it is in, if any
+    void unlink() noexcept {
+        if (next == nullptr) {
+            return;
+        }
+        prev->next = next;
+        next->prev = prev;
+        next = prev = nullptr;
+    }
+};
+
+template <class T, ListHook T::*Hook>
+class IntrusiveList {
+    // The list itself is a ring through this sentinel
+    ListHook head;
+
+    // Byte offset of the hook within T
+    static ptrdiff_t hook_offset() noexcept {
+        alignas(T) static unsigned char storage[sizeof(T)];
+        T* object = reinterpret_cast<T*>(storage);
+        return reinterpret_cast<unsigned char*>(&(object->*Hook)) - storage;
+    }
+    static T* owner(ListHook* hook) noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(hook) - hook_offset());
+    }
+    static ListHook* hook_of(T& value) noexcept {
+        return &(value.*Hook);
+    }
+
+    template <typename pointer_type, typename reference_type>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using pointer           = pointer_type;
+        using reference         = reference_type;
+    private:
+        friend class IntrusiveList;
+
+        ListHook* node;
+
+        explicit basic_iterator(ListHook* node) noexcept : node{node} {}
+
+    public:
+        basic_iterator() noexcept : node{nullptr} {}
+        // iterator converts to const_iterator, not the other way around
+        template <typename P, typename R,
+                  typename std::enable_if<std::is_convertible<P, pointer_type>::value, int>::type = 0>
+        basic_iterator(const basic_iterator<P, R>& other) noexcept : node{other.node} {}
+
+        reference operator*() const {
+            return *owner(node);
+        }
+        pointer operator->() const {
+            return owner(node);
+        }
+
+        basic_iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            node = node->next;
+            return temp;
+        }
+        basic_iterator& operator--() {
+            node = node->prev;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            basic_iterator temp = *this;
+            node = node->prev;
+            return temp;
+        }
+
+        template <typename P, typename R>
+        bool operator==(const basic_iterator<P, R>& other) const noexcept {
+            return node == other.node;
+        }
+        template <typename P, typename R>
+        bool operator!=(const basic_iterator<P, R>& other) const noexcept {
+            return node != other.node;
+        }
+
+        template <typename P, typename R>
+        friend class basic_iterator;
+    };
+
+    void steal(IntrusiveList& other) noexcept {
+        if (other.empty()) {
+            return;
+        }
+        head.next = other.head.next;
+        head.prev = other.head.prev;
+        head.next->prev = &head;
+        head.prev->next = &head;
+        other.head.next = other.head.prev = &other.head;
+    }
+
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+    using iterator        = basic_iterator<pointer, reference>;
+    using const_iterator  = basic_iterator<const_pointer, const_reference>;
+
+    IntrusiveList() noexcept {
+        head.next = head.prev = &head;
+    }
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+    IntrusiveList(IntrusiveList&& other) noexcept : IntrusiveList() {
+        steal(other);
+    }
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            steal(other);
+        }
+        return *this;
+    }
+    // Unlinks every element; the elements themselves are untouched
+    ~IntrusiveList() {
+        clear();
+        head.next = head.prev = nullptr;
+    }
+
+    reference front() {
+        return *owner(head.next);
+    }
+    const_reference front() const {
+        return *owner(head.next);
+    }
+    reference back() {
+        return *owner(head.prev);
+    }
+    const_reference back() const {
+        return *owner(head.prev);
+    }
+
+    iterator begin() noexcept {
+        return iterator(head.next);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(head.next);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    iterator end() noexcept {
+        return iterator(&head);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<ListHook*>(&head));
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+    // The position of an element known to be in this list
+    iterator iterator_to(T& value) noexcept {
+        return iterator(hook_of(value));
+    }
+
+    bool empty() const noexcept {
+        return head.next == &head;
+    }
+    // O(n): elements may unlink themselves behind the list's back
+    size_type size() const noexcept {
+        size_type count = 0;
+        for (const ListHook* curr = head.next; curr != &head; curr = curr->next) {
+            count++;
+        }
+        return count;
+    }
+
+    void clear() noexcept {
+        ListHook* curr = head.next;
+        while (curr != &head) {
+            ListHook* next = curr->next;
+            curr->next = curr->prev = nullptr;
+            curr = next;
+        }
+        head.next = head.prev = &head;
+    }
+
+    // value must not already be linked through this hook
+    iterator insert(const_iterator pos, T& value) noexcept {
+        ListHook* hook = hook_of(value);
+        hook->link_before(pos.node);
+        return iterator(hook);
+    }
+    // Unlinks the element at pos without destroying it
+    iterator erase(const_iterator pos) noexcept {
+        ListHook* next = pos.node->next;
+        pos.node->unlink();
+        return iterator(next);
+    }
+    // Unlinks value from whichever list holds it through this hook
+    static void remove(T& value) noexcept {
+        hook_of(value)->unlink();
+    }
+
+    void push_back(T& value) noexcept {
+        insert(end(), value);
+    }
+    void push_front(T& value) noexcept {
+        insert(begin(), value);
+    }
+    void pop_back() noexcept {
+        head.prev->unlink();
+    }
+    void pop_front() noexcept {
+        head.next->unlink();
+    }
+};
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <cstddef> // size_t
+#include <functional> // std::less, std::equal_to
 #include <iterator> // std::bidirectional_iterator_tag
-#include <type_traits> // std::is_same, std::enable_if
+#include <memory> // std::shared_ptr, std::make_shared
+#include <new> // placement new
+#include <type_traits> // std::is_same, std::enable_if, std::is_trivially_destructible
+#include <utility> // std::move, std::forward, std::swap
+
+#include "SlabPool.h"
 
 template <class T>
 class List {
@@ -94,15 +100,137 @@ public:
     using const_pointer   = const value_type*;
     using iterator        = basic_iterator<pointer, reference>;
     using const_iterator  = basic_iterator<const_pointer, const_reference>;
+    // Optional slab allocator for nodes, see SlabPool.h
+    using node_pool       = SlabPool<Node>;
 
 private:
     Node head, tail;
     size_type _size;
+    // nullptr: every node is its own new/delete
+    std::shared_ptr<node_pool> pool;
+
+    template <class... Args>
+    Node* make_node(Args&&... args) {
+        if (!pool) {
+            return new Node(std::forward<Args>(args)...);
+        }
+        void* storage = pool->allocate();
+        try {
+            return new (storage) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            pool->deallocate(storage);
+            throw;
+        }
+    }
+    void free_node(Node* node) noexcept {
+        if (!pool) {
+            delete node;
+            return;
+        }
+        node->~Node();
+        pool->deallocate(node);
+    }
+    // Frees every node in one walk, without unlinking them one at a time.
+    // When this list is the only user of its pool the slabs are dropped
+    // whole, and trivially destructible elements are not visited at all.
+    void release_nodes() noexcept {
+        if (pool && pool.use_count() == 1) {
+            if (!std::is_trivially_destructible<T>::value) {
+                Node* curr = head.next;
+                while (curr != &tail) {
+                    Node* next = curr->next;
+                    curr->~Node();
+                    curr = next;
+                }
+            }
+            pool->release();
+        }
+        else {
+            Node* curr = head.next;
+            while (curr != &tail) {
+                Node* next = curr->next;
+                free_node(curr);
+                curr = next;
+            }
+        }
+        head.prev = nullptr;
+        head.next = &tail;
+        tail.prev = &head;
+        tail.next = nullptr;
+        _size = 0;
+    }
+
+    // Unlinks first..last (inclusive) from their chain, which may belong to
+    // another list, and links them in before pos
+    static void relink(Node* pos, Node* first, Node* last) noexcept {
+        first->prev->next = last->next;
+        last->next->prev = first->prev;
+        first->prev = pos->prev;
+        last->next = pos;
+        pos->prev->next = first;
+        pos->prev = last;
+    }
+
+    // Merges null-terminated chain from into chain into, taking from into
+    // on ties, and leaves from empty. If comp throws, into still ends up
+    // with every node of both chains, just not in order.
+    template <class Compare>
+    static void merge_chains(Node*& into, Node*& from, Compare& comp) {
+        Node* a = into;
+        Node* b = from;
+        Node* first = nullptr;
+        Node** link = &first;
+        from = nullptr;
+        try {
+            while (a != nullptr && b != nullptr) {
+                if (comp(b->data, a->data)) {
+                    *link = b;
+                    b = b->next;
+                }
+                else {
+                    *link = a;
+                    a = a->next;
+                }
+                link = &(*link)->next;
+            }
+        }
+        catch (...) {
+            append_chain(append_chain(link, a), b);
+            into = first;
+            throw;
+        }
+        *link = a != nullptr ? a : b;
+        into = first;
+    }
+    // Hangs chain off *link and returns the link after its last node
+    static Node** append_chain(Node** link, Node* chain) noexcept {
+        *link = chain;
+        while (*link != nullptr) {
+            link = &(*link)->next;
+        }
+        return link;
+    }
+    // Makes the null-terminated chain the whole list, restoring prev links
+    void adopt_chain(Node* chain) noexcept {
+        Node* prev = &head;
+        for (Node* curr = chain; curr != nullptr; curr = curr->next) {
+            curr->prev = prev;
+            prev->next = curr;
+            prev = curr;
+        }
+        prev->next = &tail;
+        tail.prev = prev;
+    }
 
 public:
     //default cons
     List() noexcept: head(nullptr, &tail), tail(&head, nullptr), _size(0) {
     }
+    // Draws nodes from pool, which other lists may share
+    explicit List( std::shared_ptr<node_pool> pool ) noexcept
+    : head(nullptr, &tail), tail(&head, nullptr), _size(0), pool(std::move(pool)) {
+    }
     //param constr
     List( size_type count, const T& value ) : head(nullptr, &tail), tail(&head, nullptr), _size(0) {
         // for loop through count times
@@ -111,6 +239,16 @@ public:
             push_back(value);
         }
     }
+    // Reserves all count nodes from pool up front
+    List( size_type count, const T& value, std::shared_ptr<node_pool> pool )
+    : head(nullptr, &tail), tail(&head, nullptr), _size(0), pool(std::move(pool)) {
+        if (this->pool) {
+            this->pool->reserve(count);
+        }
+        for (size_type i = 0; i < count; i++) {
+            push_back(value);
+        }
+    }
     //default param constr
     explicit List( size_type count ) : head(nullptr, &tail), tail(&head, nullptr), _size(0) {
         // for loop through count times
@@ -120,7 +258,12 @@ public:
         }
     }
     //copy constr
+    // A copy of a pooled list gets a private pool holding all its nodes in one slab
     List( const List& other ): head(nullptr, &tail), tail(&head, nullptr), _size(0){
+        if (other.pool) {
+            pool = std::make_shared<node_pool>();
+            pool->reserve(other._size);
+        }
         Node* curr = other.head.next;
         while (curr != &other.tail) {
             push_back(curr->data);
@@ -128,7 +271,8 @@ public:
         }
     }
     //move constr
-    List( List&& other ): head(nullptr, &tail), tail(&head, nullptr), _size(0) {
+    // The nodes stay in their pool, so it moves along with them
+    List( List&& other ): head(nullptr, &tail), tail(&head, nullptr), _size(0), pool(std::move(other.pool)) {
         if (other._size > 0) {
             head.next = other.head.next;
             tail.prev = other.tail.prev;
@@ -150,6 +294,9 @@ public:
             return *this;
         }
         clear();
+        if (pool) {
+            pool->reserve(other._size);
+        }
         Node* curr = other.head.next;
         while (curr != &other.tail) {
             push_back(curr->data);
@@ -164,6 +311,7 @@ public:
             return *this;
         }
         clear();
+        pool = std::move(other.pool);
         if (other._size > 0) {
             head.next = other.head.next;
             tail.prev = other.tail.prev;
@@ -223,13 +371,11 @@ public:
     }
 
     void clear() noexcept {
-        while (_size != 0) {
-            pop_back();
-        }
+        release_nodes();
     }
     
     iterator insert( const_iterator pos, const T& value ) {
-        Node* in = new Node(value);
+        Node* in = make_node(value);
         in->next = pos.node;
         in->prev = pos.node->prev;
         pos.node->prev = in;
@@ -239,7 +385,7 @@ public:
 
     }
     iterator insert( const_iterator pos, T&& value ) {
-        Node* in = new Node(std::move(value));
+        Node* in = make_node(std::move(value));
         in->next = pos.node;
         in->prev = pos.node->prev;
         pos.node->prev = in;
@@ -254,7 +400,7 @@ public:
         Node* temp = pos.node->next;
         pos.node->next = nullptr;
         pos.node->prev = nullptr;
-        delete pos.node;
+        free_node(pos.node);
         _size--;
         if (_size == 0) {
             head.prev = nullptr;
@@ -287,6 +433,199 @@ public:
         erase(const_iterator(head.next));
     }
 
+    // Moves [first, last) of other before pos by relinking the nodes. Only
+    // counting the range for the sizes is linear; moving within one list is
+    // O(1). Lists drawing from different pools cannot trade nodes, so then
+    // the elements are moved into new nodes instead.
+    void splice( const_iterator pos, List& other, const_iterator first, const_iterator last ) {
+        if (first == last) {
+            return;
+        }
+        if (this == &other) {
+            if (pos != first) {
+                relink(pos.node, first.node, last.node->prev);
+            }
+            return;
+        }
+        if (pool != other.pool) {
+            while (first != last) {
+                Node* next = first.node->next;
+                insert(pos, std::move(first.node->data));
+                other.erase(first);
+                first = const_iterator(next);
+            }
+            return;
+        }
+        size_type count = 0;
+        for (Node* curr = first.node; curr != last.node; curr = curr->next) {
+            count++;
+        }
+        relink(pos.node, first.node, last.node->prev);
+        _size += count;
+        other._size -= count;
+    }
+    void splice( const_iterator pos, List& other, const_iterator it ) {
+        const_iterator next(it.node->next);
+        if (pos == it || pos == next) {
+            return;
+        }
+        splice(pos, other, it, next);
+    }
+    void splice( const_iterator pos, List& other ) {
+        if (this != &other) {
+            splice(pos, other, other.cbegin(), other.cend());
+        }
+    }
+    void splice( const_iterator pos, List&& other ) {
+        splice(pos, other);
+    }
+
+    // Merges sorted other into this sorted list, leaving other empty. Equal
+    // elements of this list stay ahead of those from other. If comp throws,
+    // every element is still in one of the two lists.
+    template <class Compare>
+    void merge( List& other, Compare comp ) {
+        if (this == &other || other._size == 0) {
+            return;
+        }
+        if (pool != other.pool) {
+            List moved(pool);
+            moved.splice(moved.cend(), other);
+            try {
+                merge(moved, comp);
+            }
+            catch (...) {
+                splice(cend(), moved);
+                throw;
+            }
+            return;
+        }
+        Node* a = head.next;
+        Node* b = other.head.next;
+        while (a != &tail && b != &other.tail) {
+            if (!comp(b->data, a->data)) {
+                a = a->next;
+                continue;
+            }
+            // Move the whole run of other that goes before a at once
+            Node* run_end = b;
+            size_type run = 1;
+            while (run_end->next != &other.tail && comp(run_end->next->data, a->data)) {
+                run_end = run_end->next;
+                run++;
+            }
+            Node* next = run_end->next;
+            relink(a, b, run_end);
+            _size += run;
+            other._size -= run;
+            b = next;
+        }
+        if (b != &other.tail) {
+            relink(&tail, b, other.tail.prev);
+        }
+        _size += other._size;
+        other._size = 0;
+    }
+    void merge( List& other ) {
+        merge(other, std::less<T>());
+    }
+    void merge( List&& other ) {
+        merge(other);
+    }
+
+    // Stable bottom-up merge sort. Only relinks nodes: elements are never
+    // copied or moved and nothing is allocated. If comp throws, the list
+    // keeps every element in an unspecified order.
+    template <class Compare>
+    void sort( Compare comp ) {
+        if (_size < 2) {
+            return;
+        }
+        // bins[i] holds a sorted chain of 2^i nodes, older than the ones
+        // below it. Every node is always in exactly one of bins, chain,
+        // rest and sorted.
+        Node* bins[64] = {};
+        Node* chain = nullptr;
+        Node* sorted = nullptr;
+        tail.prev->next = nullptr;
+        Node* rest = head.next;
+        try {
+            while (rest != nullptr) {
+                chain = rest;
+                rest = rest->next;
+                chain->next = nullptr;
+                size_t i = 0;
+                for (; i < 63 && bins[i] != nullptr; i++) {
+                    merge_chains(bins[i], chain, comp);
+                    std::swap(chain, bins[i]);
+                }
+                std::swap(chain, bins[i]);
+            }
+            for (Node*& bin : bins) {
+                if (bin != nullptr) {
+                    merge_chains(bin, sorted, comp);
+                    std::swap(sorted, bin);
+                }
+            }
+        }
+        catch (...) {
+            Node* all = nullptr;
+            Node** link = append_chain(&all, sorted);
+            link = append_chain(link, chain);
+            link = append_chain(link, rest);
+            for (Node* bin : bins) {
+                link = append_chain(link, bin);
+            }
+            adopt_chain(all);
+            throw;
+        }
+        adopt_chain(sorted);
+    }
+    void sort() {
+        sort(std::less<T>());
+    }
+
+    void reverse() noexcept {
+        if (_size < 2) {
+            return;
+        }
+        Node* first = head.next;
+        Node* last = tail.prev;
+        for (Node* curr = first; curr != &tail;) {
+            Node* next = curr->next;
+            std::swap(curr->next, curr->prev);
+            curr = next;
+        }
+        head.next = last;
+        last->prev = &head;
+        tail.prev = first;
+        first->next = &tail;
+    }
+
+    // Erases all but the first of each run of equal elements, returning how
+    // many were erased
+    template <class BinaryPredicate>
+    size_type unique( BinaryPredicate equal ) {
+        size_type removed = 0;
+        if (_size == 0) {
+            return removed;
+        }
+        Node* curr = head.next;
+        while (curr->next != &tail) {
+            if (equal(curr->data, curr->next->data)) {
+                erase(const_iterator(curr->next));
+                removed++;
+            }
+            else {
+                curr = curr->next;
+            }
+        }
+        return removed;
+    }
+    size_type unique() {
+        return unique(std::equal_to<T>());
+    }
+
     /*
       You do not need to modify these methods!
       
@@ -304,6 +643,19 @@ public:
     iterator erase( iterator pos ) {
         return erase((const_iterator&)(pos));
     }
+
+    void splice( iterator pos, List& other ) {
+        splice((const_iterator&)(pos), other);
+    }
+    void splice( iterator pos, List&& other ) {
+        splice((const_iterator&)(pos), other);
+    }
+    void splice( iterator pos, List& other, iterator it ) {
+        splice((const_iterator&)(pos), other, (const_iterator&)(it));
+    }
+    void splice( iterator pos, List& other, iterator first, iterator last ) {
+        splice((const_iterator&)(pos), other, (const_iterator&)(first), (const_iterator&)(last));
+    }
 };
 
 
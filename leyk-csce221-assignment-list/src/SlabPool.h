@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef> // size_t, max_align_t
+#include <new> // ::operator new, ::operator delete
+
+/*
+    SlabPool
+    --------
+
+    Hands out uninitialized storage for single objects of type T, carved out
+    of large contiguous slabs instead of one heap allocation per object.
+    Freed objects go onto an intrusive free list (the link is stored in the
+    freed object's own storage) and are handed out again before fresh
+    storage is used.
+
+    release() frees every slab at once, so a container that knows it holds
+    the last live object can drop them all without visiting any of them.
+    reserve(n) guarantees the next n allocations need no new slab, and
+    places those that are fresh in one contiguous run.
+
+    A pool may be shared by several containers; nothing here is thread-safe.
+
+    Example:
+    {
+        auto pool = std::make_shared<List<int>::node_pool>();
+        List<int> a(pool), b(pool);     // both draw nodes from the same slabs
+    }
+*/
+template <class T>
+class SlabPool {
+    union Chunk {
+        Chunk* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    static_assert(alignof(Chunk) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+    // Chunks follow the header, which is padded to a multiple of their alignment
+    struct alignas(Chunk) Slab {
+        Slab* next;
+        size_t count;
+
+        Chunk* chunks() noexcept {
+            return reinterpret_cast<Chunk*>(this + 1);
+        }
+    };
+
+    Slab* slabs;
+    Chunk* free_list;
+    // Never used storage at the end of the newest slab
+    Chunk *fresh, *fresh_end;
+    size_t n_free;
+    size_t n_slabs;
+    size_t slab_nodes;
+
+    void grow(size_t count) {
+        // Whatever is left of the old slab is kept on the free list
+        while (fresh != fresh_end) {
+            push_free(fresh++);
+        }
+        Slab* slab = static_cast<Slab*>(::operator new(sizeof(Slab) + count * sizeof(Chunk)));
+        slab->next = slabs;
+        slab->count = count;
+        slabs = slab;
+        fresh = slab->chunks();
+        fresh_end = fresh + count;
+        n_slabs++;
+    }
+
+    void push_free(Chunk* chunk) noexcept {
+        chunk->next = free_list;
+        free_list = chunk;
+        n_free++;
+    }
+
+public:
+    // Sized so a slab is roughly 64 KiB
+    static constexpr size_t default_slab_nodes = sizeof(Chunk) >= 4096 ? 16 : 65536 / sizeof(Chunk);
+
+    explicit SlabPool(size_t slab_nodes = default_slab_nodes) noexcept
+    : slabs(nullptr), free_list(nullptr), fresh(nullptr), fresh_end(nullptr),
+      n_free(0), n_slabs(0), slab_nodes(slab_nodes == 0 ? 1 : slab_nodes) {}
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+        release();
+    }
+
+    // Storage for one T; construct into it with placement new
+    void* allocate() {
+        if (free_list != nullptr) {
+            Chunk* chunk = free_list;
+            free_list = chunk->next;
+            n_free--;
+            return chunk->storage;
+        }
+        if (fresh == fresh_end) {
+            grow(slab_nodes);
+        }
+        return (fresh++)->storage;
+    }
+    // p must come from allocate() and its object must already be destroyed
+    void deallocate(void* p) noexcept {
+        push_free(static_cast<Chunk*>(p));
+    }
+
+    // Makes sure the next count allocations fit in the slabs already held
+    void reserve(size_t count) {
+        size_t available = n_free + (fresh_end - fresh);
+        if (available < count) {
+            grow(count - n_free > slab_nodes ? count - n_free : slab_nodes);
+        }
+    }
+
+    // Frees every slab. Every object allocated from the pool must already
+    // be destroyed or simply abandoned.
+    void release() noexcept {
+        while (slabs != nullptr) {
+            Slab* next = slabs->next;
+            ::operator delete(slabs);
+            slabs = next;
+        }
+        free_list = nullptr;
+        fresh = fresh_end = nullptr;
+        n_free = 0;
+        n_slabs = 0;
+    }
+
+    size_t slab_count() const noexcept {
+        return n_slabs;
+    }
+};
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <iterator> // std::bidirectional_iterator_tag
+#include <new> // placement new
+#include <type_traits> // std::enable_if, std::is_convertible
+#include <utility> // std::move
+
+/*
+    UnrolledList
+    ------------
+
+    A doubly linked list whose nodes each hold up to K elements in a small
+    inline array. Walking it touches one node per K elements instead of one
+    per element, and the two links are paid once per node, so for small T
+    both traversal and memory use improve by roughly a factor of K.
+
+    It has List's interface: bidirectional iterators, insert before an
+    iterator, erase at one, and push/pop at either end. Inserting into a
+    full node splits it in half (or, at either edge of the node, starts a
+    new one, so pushing at the ends keeps nodes full). Erasing from a node
+    that drops below half full merges it with its successor when they fit
+    in one node. Either shifts at most K elements within one node.
+
+    Unlike List, insert and erase invalidate iterators into the node they
+    touch and into a node they split or merge with.
+
+    K defaults to about 256 bytes of elements per node.
+
+    Example:
+    {
+        UnrolledList<Descriptor> queue;
+        queue.push_back(d);
+        for (const Descriptor& d : queue) { ... }   // one miss per node
+    }
+*/
+template <class T, size_t K = (256 / sizeof(T) > 4 ? 256 / sizeof(T) : 4)>
+class UnrolledList {
+    static_assert(K >= 2, "a node must hold at least two elements");
+
+    // The sentinel is a bare Link with count 0, every other Link is a Node
+    struct Link {
+        Link *next, *prev;
+        size_t count;
+    };
+    struct Node : Link {
+        alignas(T) unsigned char storage[K * sizeof(T)];
+
+        T* data() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    static T& element(Link* link, size_t idx) noexcept {
+        return static_cast<Node*>(link)->data()[idx];
+    }
+
+    template <typename pointer_type, typename reference_type>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using pointer           = pointer_type;
+        using reference         = reference_type;
+    private:
+        friend class UnrolledList;
+
+        Link* node;
+        size_t idx;
+
+        basic_iterator(Link* node, size_t idx) noexcept : node{node}, idx{idx} {}
+
+    public:
+        basic_iterator() noexcept : node{nullptr}, idx{0} {}
+        // iterator converts to const_iterator, not the other way around
+        template <typename P, typename R,
+                  typename std::enable_if<std::is_convertible<P, pointer_type>::value, int>::type = 0>
+        basic_iterator(const basic_iterator<P, R>& other) noexcept : node{other.node}, idx{other.idx} {}
+
+        reference operator*() const {
+            return element(node, idx);
+        }
+        pointer operator->() const {
+            return &element(node, idx);
+        }
+
+        basic_iterator& operator++() {
+            if (++idx == node->count) {
+                node = node->next;
+                idx = 0;
+            }
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+        basic_iterator& operator--() {
+            if (idx == 0) {
+                node = node->prev;
+                idx = node->count;
+            }
+            idx--;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            basic_iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        template <typename P, typename R>
+        bool operator==(const basic_iterator<P, R>& other) const noexcept {
+            return node == other.node && idx == other.idx;
+        }
+        template <typename P, typename R>
+        bool operator!=(const basic_iterator<P, R>& other) const noexcept {
+            return !(*this == other);
+        }
+
+        template <typename P, typename R>
+        friend class basic_iterator;
+    };
+
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+    using iterator        = basic_iterator<pointer, reference>;
+    using const_iterator  = basic_iterator<const_pointer, const_reference>;
+
+private:
+    Link sentinel;
+    size_type _size;
+
+    // Links an empty node in before pos
+    Node* add_node(Link* pos) {
+        Node* node = new Node;
+        node->count = 0;
+        node->next = pos;
+        node->prev = pos->prev;
+        pos->prev->next = node;
+        pos->prev = node;
+        return node;
+    }
+    void remove_node(Link* node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        delete static_cast<Node*>(node);
+    }
+
+    // Moves src[first, src->count) to the end of dst
+    static void move_tail(Link* src, size_t first, Link* dst) noexcept {
+        for (size_t i = first; i < src->count; i++) {
+            new (&element(dst, dst->count++)) T(std::move(element(src, i)));
+            element(src, i).~T();
+        }
+        src->count = first;
+    }
+
+    // Where an element inserted before pos goes, making room if the node is full
+    iterator make_room(const_iterator pos) {
+        Link* node = pos.node;
+        size_t idx = pos.idx;
+        if (node == &sentinel) {
+            node = sentinel.prev;
+            idx = node->count;
+            if (node == &sentinel || idx == K) {
+                return iterator(add_node(&sentinel), 0);
+            }
+        }
+        if (node->count < K) {
+            return iterator(node, idx);
+        }
+        if (idx == 0) {
+            if (node->prev != &sentinel && node->prev->count < K) {
+                return iterator(node->prev, node->prev->count);
+            }
+            return iterator(add_node(node), 0);
+        }
+        // Split the full node in half
+        Node* upper = add_node(node->next);
+        move_tail(node, K / 2, upper);
+        if (idx > K / 2) {
+            return iterator(upper, idx - K / 2);
+        }
+        return iterator(node, idx);
+    }
+
+    iterator emplace(const_iterator pos, T&& value) {
+        iterator at = make_room(pos);
+        Link* node = at.node;
+        T* data = static_cast<Node*>(node)->data();
+        if (at.idx == node->count) {
+            new (&data[at.idx]) T(std::move(value));
+        }
+        else {
+            new (&data[node->count]) T(std::move(data[node->count - 1]));
+            for (size_t i = node->count - 1; i > at.idx; i--) {
+                data[i] = std::move(data[i - 1]);
+            }
+            data[at.idx] = std::move(value);
+        }
+        node->count++;
+        _size++;
+        return at;
+    }
+
+    void steal(UnrolledList& other) noexcept {
+        if (other._size == 0) {
+            return;
+        }
+        sentinel.next = other.sentinel.next;
+        sentinel.prev = other.sentinel.prev;
+        sentinel.next->prev = &sentinel;
+        sentinel.prev->next = &sentinel;
+        _size = other._size;
+        other.sentinel.next = other.sentinel.prev = &other.sentinel;
+        other._size = 0;
+    }
+
+public:
+    UnrolledList() noexcept : sentinel{&sentinel, &sentinel, 0}, _size(0) {}
+    UnrolledList(size_type count, const T& value) : UnrolledList() {
+        for (size_type i = 0; i < count; i++) {
+            push_back(value);
+        }
+    }
+    explicit UnrolledList(size_type count) : UnrolledList() {
+        for (size_type i = 0; i < count; i++) {
+            push_back(T());
+        }
+    }
+    UnrolledList(const UnrolledList& other) : UnrolledList() {
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+    UnrolledList(UnrolledList&& other) noexcept : UnrolledList() {
+        steal(other);
+    }
+    ~UnrolledList() {
+        clear();
+    }
+
+    UnrolledList& operator=(const UnrolledList& other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        for (const T& value : other) {
+            push_back(value);
+        }
+        return *this;
+    }
+    UnrolledList& operator=(UnrolledList&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        steal(other);
+        return *this;
+    }
+
+    reference front() {
+        return element(sentinel.next, 0);
+    }
+    const_reference front() const {
+        return element(sentinel.next, 0);
+    }
+    reference back() {
+        return element(sentinel.prev, sentinel.prev->count - 1);
+    }
+    const_reference back() const {
+        return element(sentinel.prev, sentinel.prev->count - 1);
+    }
+
+    iterator begin() noexcept {
+        return iterator(sentinel.next, 0);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(sentinel.next, 0);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    iterator end() noexcept {
+        return iterator(&sentinel, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<Link*>(&sentinel), 0);
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+    size_type size() const noexcept {
+        return _size;
+    }
+
+    void clear() noexcept {
+        Link* node = sentinel.next;
+        while (node != &sentinel) {
+            Link* next = node->next;
+            for (size_t i = 0; i < node->count; i++) {
+                element(node, i).~T();
+            }
+            delete static_cast<Node*>(node);
+            node = next;
+        }
+        sentinel.next = sentinel.prev = &sentinel;
+        _size = 0;
+    }
+
+    iterator insert(const_iterator pos, const T& value) {
+        // value may live in this list, so copy it before anything moves
+        T copy(value);
+        return emplace(pos, std::move(copy));
+    }
+    iterator insert(const_iterator pos, T&& value) {
+        T moved(std::move(value));
+        return emplace(pos, std::move(moved));
+    }
+
+    iterator erase(const_iterator pos) {
+        Link* node = pos.node;
+        size_t idx = pos.idx;
+        T* data = static_cast<Node*>(node)->data();
+        for (size_t i = idx; i + 1 < node->count; i++) {
+            data[i] = std::move(data[i + 1]);
+        }
+        data[--node->count].~T();
+        _size--;
+
+        if (node->count == 0) {
+            Link* next = node->next;
+            remove_node(node);
+            return iterator(next, 0);
+        }
+        Link* next = node->next;
+        if (node->count < K / 2 && next != &sentinel && node->count + next->count <= K) {
+            move_tail(next, 0, node);
+            remove_node(next);
+        }
+        if (idx == node->count) {
+            return iterator(node->next, 0);
+        }
+        return iterator(node, idx);
+    }
+
+    void push_back(const T& value) {
+        insert(end(), value);
+    }
+    void push_back(T&& value) {
+        insert(end(), std::move(value));
+    }
+    void pop_back() {
+        erase(--end());
+    }
+    void push_front(const T& value) {
+        insert(begin(), value);
+    }
+    void push_front(T&& value) {
+        insert(begin(), std::move(value));
+    }
+    void pop_front() {
+        erase(begin());
+    }
+};
@@ -1,6 +1,7 @@
 #include "executable.h"
 #include "box.h"
 #include <list>
+#include <memory>
 
 TEST(clear_and_empty) {
     Typegen t;
@@ -88,3 +89,37 @@ TEST(use_after_clear) {
         }
     }
 }
+
+
+TEST(clear_releases_in_bulk) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 1000);
+
+        // Every node and every element is freed exactly once
+        {
+            List<Box<int>> ll;
+            for(size_t j = 0; j < sz; j++)
+                ll.push_back(Box<int>(t.get<int>()));
+            Memhook mh;
+            ll.clear();
+            ASSERT_EQ(2 * sz, mh.n_frees());
+            ASSERT_TRUE(ll.begin() == ll.end());
+        }
+
+        // A list that owns its pool hands back whole slabs
+        {
+            const size_t slab = t.range<size_t>(1, 64);
+            List<int> ll(std::make_shared<List<int>::node_pool>(slab));
+            for(size_t j = 0; j < sz; j++)
+                ll.push_back(t.get<int>());
+            Memhook mh;
+            ll.clear();
+            ASSERT_EQ((sz + slab - 1) / slab, mh.n_frees());
+            ASSERT_TRUE(ll.empty());
+
+            ll.push_back(1);
+            ASSERT_EQ(1, ll.front());
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#include "executable.h"
+#include "box.h"
+#include "CompactList.h"
+#include <algorithm>
+#include <list>
+#include <string>
+#include <type_traits>
+
+// Iterators only convert towards const
+static_assert(std::is_convertible<CompactList<int>::iterator, CompactList<int>::const_iterator>::value, "");
+static_assert(!std::is_convertible<CompactList<int>::const_iterator, CompactList<int>::iterator>::value, "");
+
+namespace {
+    template <class T, class List>
+    bool matches(const std::list<T> & gt, const List & ll) {
+        if(gt.size() != ll.size())
+            return false;
+        if(!std::equal(gt.begin(), gt.end(), ll.begin()))
+            return false;
+        auto gt_it = gt.end();
+        auto it = ll.end();
+        while(gt_it != gt.begin())
+            if(!(*--gt_it == *--it))
+                return false;
+        return it == ll.begin();
+    }
+}
+
+TEST(compact_list_insert_erase) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t ops = t.range<size_t>(1000);
+        CompactList<int> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < ops; j++) {
+            size_t pos = t.range<size_t>(gt.size() + 1);
+            auto it = std::next(ll.begin(), pos);
+            auto gt_it = std::next(gt.begin(), pos);
+            if(pos < gt.size() && t.range<int>(0, 3) == 0) {
+                it = ll.erase(it);
+                gt_it = gt.erase(gt_it);
+            }
+            else {
+                int v = t.get<int>();
+                it = ll.insert(it, v);
+                gt_it = gt.insert(gt_it, v);
+            }
+            ASSERT_EQ(std::distance(gt.begin(), gt_it), std::distance(ll.begin(), it));
+        }
+        ASSERT_TRUE(matches(gt, ll));
+        if(!gt.empty()) {
+            ASSERT_EQ(gt.front(), ll.front());
+            ASSERT_EQ(gt.back(), ll.back());
+        }
+
+        while(!gt.empty()) {
+            if(t.range<int>(0, 2)) {
+                ll.pop_back();
+                gt.pop_back();
+            }
+            else {
+                ll.pop_front();
+                gt.pop_front();
+            }
+        }
+        ASSERT_TRUE(ll.empty());
+        ASSERT_TRUE(ll.begin() == ll.end());
+    }
+}
+
+TEST(compact_list_one_array) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 1000);
+
+        Memhook mh;
+        CompactList<int> ll;
+        ASSERT_EQ(0ULL, mh.n_allocs());
+        for(size_t j = 0; j < sz; j++)
+            ll.push_back(int(j));
+        // The array doubles, so there are only logarithmically many allocations
+        ASSERT_LE(mh.n_allocs(), 12ULL);
+        ASSERT_EQ(mh.n_allocs() - 1, mh.n_frees());
+
+        // Erased nodes are reused before the array grows
+        size_t allocs = mh.n_allocs();
+        for(size_t j = 0; j < sz; j++) {
+            ll.pop_front();
+            ll.push_back(int(j));
+        }
+        ll.clear();
+        for(size_t j = 0; j < sz; j++)
+            ll.push_front(int(j));
+        ASSERT_EQ(allocs, mh.n_allocs());
+
+        // reserve allocates exactly once
+        CompactList<int> reserved;
+        reserved.reserve(sz);
+        allocs = mh.n_allocs();
+        for(size_t j = 0; j < sz; j++)
+            reserved.push_back(int(j));
+        ASSERT_EQ(allocs, mh.n_allocs());
+        ASSERT_GE(reserved.capacity(), sz);
+    }
+}
+
+TEST(compact_list_iterators_survive_growth) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        CompactList<std::string> ll;
+        std::list<std::string> gt;
+        auto it = ll.insert(ll.end(), "anchor");
+        gt.push_back("anchor");
+        for(size_t j = t.range<size_t>(1, 500); j > 0; j--) {
+            std::string s = std::to_string(t.get<int>());
+            if(t.range<int>(0, 2)) {
+                ll.push_back(s);
+                gt.push_back(s);
+            }
+            else {
+                ll.push_front(s);
+                gt.push_front(s);
+            }
+        }
+        // The array moved several times, the logical position did not
+        ASSERT_TRUE(*it == "anchor");
+        ll.erase(it);
+        gt.remove("anchor");
+        ASSERT_TRUE(matches(gt, ll));
+
+        // Inserting an element of the list itself while it grows
+        for(size_t j = 0; j < 50; j++) {
+            ll.push_back(ll.front());
+            gt.push_back(gt.front());
+        }
+        ASSERT_TRUE(matches(gt, ll));
+    }
+}
+
+TEST(compact_list_copy_move) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(300);
+
+        Memhook mh;
+        {
+            std::list<int> gt;
+            CompactList<Box<int>> boxes;
+            CompactList<int> ints;
+            for(size_t j = 0; j < sz; j++) {
+                int v = t.get<int>();
+                boxes.push_back(Box<int>(v));
+                ints.push_back(v);
+                gt.push_back(v);
+                if(t.range<int>(0, 4) == 0) {
+                    boxes.pop_front();
+                    ints.pop_front();
+                    gt.pop_front();
+                }
+            }
+
+            // A copy of trivially copyable elements is one allocation
+            size_t allocs = mh.n_allocs();
+            CompactList<int> ints_copy(ints);
+            ASSERT_LE(mh.n_allocs(), allocs + 1);
+            ASSERT_TRUE(matches(gt, ints_copy));
+
+            CompactList<Box<int>> boxes_copy(boxes);
+            auto gt_it = gt.begin();
+            for(const Box<int> & b : boxes_copy)
+                ASSERT_EQ(*gt_it++, *b);
+
+            CompactList<int> moved(std::move(ints));
+            ASSERT_TRUE(ints.empty());
+            ASSERT_TRUE(ints.begin() == ints.end());
+            ASSERT_TRUE(matches(gt, moved));
+
+            // Moved-from lists are usable again
+            ints.push_back(1);
+            ASSERT_EQ(1, ints.front());
+            ints = moved;
+            ASSERT_TRUE(matches(gt, ints));
+            boxes = std::move(boxes_copy);
+            ASSERT_EQ(gt.size(), boxes.size());
+        }
+        ASSERT_EQ(mh.n_allocs(), mh.n_frees());
+    }
+}
@@ -0,0 +1,179 @@
+#include "executable.h"
+#include "IntrusiveList.h"
+#include <algorithm>
+#include <list>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    struct Task {
+        int id;
+        ListHook run;
+        ListHook all;
+        explicit Task(int id = 0) : id(id) {}
+    };
+
+    using RunQueue = IntrusiveList<Task, &Task::run>;
+    using AllTasks = IntrusiveList<Task, &Task::all>;
+
+    // Iterators only convert towards const
+    static_assert(std::is_convertible<RunQueue::iterator, RunQueue::const_iterator>::value, "");
+    static_assert(!std::is_convertible<RunQueue::const_iterator, RunQueue::iterator>::value, "");
+
+    template <class List>
+    bool matches(const std::list<int> & gt, const List & ll) {
+        if(gt.size() != ll.size())
+            return false;
+        auto it = ll.begin();
+        for(int id : gt)
+            if((it++)->id != id)
+                return false;
+        auto gt_it = gt.end();
+        it = ll.end();
+        while(gt_it != gt.begin())
+            if(*--gt_it != (--it)->id)
+                return false;
+        return true;
+    }
+}
+
+TEST(intrusive_list_no_allocations) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 200);
+        std::vector<Task> tasks;
+        for(size_t j = 0; j < sz; j++)
+            tasks.emplace_back(int(j));
+
+        Memhook mh;
+        {
+            RunQueue queue;
+            for(Task & task : tasks) {
+                if(t.range<int>(0, 2))
+                    queue.push_back(task);
+                else
+                    queue.push_front(task);
+            }
+            ASSERT_EQ(sz, queue.size());
+            while(!queue.empty()) {
+                if(t.range<int>(0, 2))
+                    queue.pop_back();
+                else
+                    queue.pop_front();
+            }
+            ASSERT_TRUE(queue.begin() == queue.end());
+        }
+        ASSERT_EQ(0ULL, mh.n_allocs());
+        for(Task & task : tasks)
+            ASSERT_FALSE(task.run.is_linked());
+    }
+}
+
+TEST(intrusive_list_insert_erase) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 200);
+        std::vector<Task> tasks;
+        for(size_t j = 0; j < sz; j++)
+            tasks.emplace_back(int(j));
+
+        RunQueue queue;
+        std::list<int> gt;
+        for(Task & task : tasks) {
+            size_t pos = t.range<size_t>(gt.size() + 1);
+            auto it = queue.insert(std::next(queue.begin(), pos), task);
+            gt.insert(std::next(gt.begin(), pos), task.id);
+            ASSERT_EQ(&task, &*it);
+        }
+        ASSERT_TRUE(matches(gt, queue));
+
+        for(size_t j = t.range<size_t>(sz); j > 0; j--) {
+            size_t pos = t.range<size_t>(gt.size());
+            auto it = queue.erase(std::next(queue.begin(), pos));
+            auto gt_it = gt.erase(std::next(gt.begin(), pos));
+            ASSERT_TRUE((it == queue.end()) == (gt_it == gt.end()));
+            if(gt_it != gt.end())
+                ASSERT_EQ(*gt_it, it->id);
+        }
+        ASSERT_TRUE(matches(gt, queue));
+    }
+}
+
+TEST(intrusive_list_two_hooks) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 200);
+        std::vector<Task> tasks;
+        for(size_t j = 0; j < sz; j++)
+            tasks.emplace_back(int(j));
+
+        RunQueue queue;
+        AllTasks all;
+        std::list<int> gt_queue, gt_all;
+        for(Task & task : tasks) {
+            all.push_back(task);
+            gt_all.push_back(task.id);
+            if(t.range<int>(0, 2)) {
+                queue.push_front(task);
+                gt_queue.push_front(task.id);
+            }
+        }
+        ASSERT_TRUE(matches(gt_queue, queue));
+        ASSERT_TRUE(matches(gt_all, all));
+
+        // Unlinking from a pointer alone, through either hook
+        for(size_t j = t.range<size_t>(sz); j > 0; j--) {
+            Task & task = tasks[t.range<size_t>(sz)];
+            if(t.range<int>(0, 2)) {
+                task.run.unlink();
+                gt_queue.remove(task.id);
+            }
+            else {
+                AllTasks::remove(task);
+                gt_all.remove(task.id);
+            }
+        }
+        ASSERT_TRUE(matches(gt_queue, queue));
+        ASSERT_TRUE(matches(gt_all, all));
+
+        // Moving the list moves the ring, not the elements
+        RunQueue moved(std::move(queue));
+        ASSERT_TRUE(queue.empty());
+        ASSERT_TRUE(matches(gt_queue, moved));
+        if(!gt_queue.empty()) {
+            ASSERT_EQ(gt_queue.front(), moved.front().id);
+            ASSERT_EQ(gt_queue.back(), moved.back().id);
+            ASSERT_TRUE(moved.iterator_to(moved.front()) == moved.begin());
+        }
+    }
+}
+
+TEST(intrusive_list_auto_unlink) {
+    RunQueue queue;
+    Task first(1), last(3);
+    queue.push_back(first);
+    {
+        Task middle(2);
+        queue.push_back(middle);
+        queue.push_back(last);
+
+        // Copies are not linked anywhere
+        Task copy(middle);
+        ASSERT_FALSE(copy.run.is_linked());
+        ASSERT_EQ(3ULL, queue.size());
+    }
+    // middle left the list when it was destroyed
+    ASSERT_EQ(2ULL, queue.size());
+    ASSERT_EQ(1, queue.front().id);
+    ASSERT_EQ(3, queue.back().id);
+
+    queue.pop_front();
+    {
+        RunQueue other;
+        other.push_back(first);
+    }
+    // A destroyed list leaves its elements unlinked
+    ASSERT_FALSE(first.run.is_linked());
+    ASSERT_EQ(1ULL, queue.size());
+    ASSERT_EQ(3, queue.front().id);
+}
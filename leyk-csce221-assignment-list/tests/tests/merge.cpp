@@ -0,0 +1,124 @@
+#include "executable.h"
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    struct Keyed {
+        int key;
+        size_t order;
+        Keyed() : key(0), order(0) {}
+        Keyed(int key, size_t order) : key(key), order(order) {}
+        bool operator==(const Keyed & other) const {
+            return key == other.key && order == other.order;
+        }
+    };
+    bool by_key(const Keyed & a, const Keyed & b) {
+        return a.key < b.key;
+    }
+
+    void fill_sorted(Typegen & t, List<Keyed> & ll, std::list<Keyed> & gt, size_t sz, size_t tag) {
+        std::vector<int> keys;
+        for(size_t i = 0; i < sz; i++)
+            keys.push_back(t.range<int>(0, 20));
+        std::sort(keys.begin(), keys.end());
+        for(size_t i = 0; i < sz; i++) {
+            ll.push_back(Keyed(keys[i], tag + i));
+            gt.push_back(Keyed(keys[i], tag + i));
+        }
+    }
+}
+
+TEST(merge) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        List<Keyed> a, b;
+        std::list<Keyed> gt_a, gt_b;
+        fill_sorted(t, a, gt_a, t.range<size_t>(100), 0);
+        fill_sorted(t, b, gt_b, t.range<size_t>(100), 1000);
+
+        Memhook mh;
+        a.merge(b, by_key);
+        ASSERT_EQ(0ULL, mh.n_allocs());
+        ASSERT_EQ(0ULL, mh.n_frees());
+        gt_a.merge(gt_b, by_key);
+
+        // Stable: among equal keys, a's elements come first
+        ASSERT_EQ(gt_a.size(), a.size());
+        ASSERT_TRUE(b.empty());
+        ASSERT_TRUE(std::equal(gt_a.begin(), gt_a.end(), a.begin()));
+        ASSERT_TRUE(std::equal(gt_a.rbegin(), gt_a.rend(), std::make_reverse_iterator(a.end())));
+    }
+}
+
+TEST(merge_default_and_pools) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        List<int> a(std::make_shared<List<int>::node_pool>()), b;
+        std::list<int> gt_a, gt_b;
+        for(size_t j = t.range<size_t>(100); j > 0; j--) {
+            int v = t.range<int>(0, 50);
+            a.push_back(v);
+            gt_a.push_back(v);
+        }
+        for(size_t j = t.range<size_t>(100); j > 0; j--) {
+            int v = t.range<int>(0, 50);
+            b.push_back(v);
+            gt_b.push_back(v);
+        }
+        a.sort();
+        b.sort();
+        gt_a.sort();
+        gt_b.sort();
+
+        a.merge(std::move(b));
+        gt_a.merge(gt_b);
+        ASSERT_EQ(gt_a.size(), a.size());
+        ASSERT_TRUE(b.empty());
+        ASSERT_TRUE(std::equal(gt_a.begin(), gt_a.end(), a.begin()));
+    }
+}
+
+TEST(merge_throwing_comparator) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        // Separate pools make merge move the elements into new nodes first
+        bool pooled = t.get<bool>();
+        List<int> a(pooled ? std::make_shared<List<int>::node_pool>() : nullptr), b;
+        std::vector<int> gt;
+        for(size_t j = t.range<size_t>(100); j > 0; j--)
+            gt.push_back(t.range<int>(0, 50));
+        size_t split = t.range<size_t>(gt.size() + 1);
+        std::sort(gt.begin(), gt.begin() + split);
+        std::sort(gt.begin() + split, gt.end());
+        for(size_t j = 0; j < gt.size(); j++)
+            (j < split ? a : b).push_back(gt[j]);
+
+        size_t calls = t.range<size_t>(gt.size() + 1);
+        try {
+            a.merge(b, [&calls](int x, int y) {
+                if(calls-- == 0)
+                    throw std::runtime_error("comparator");
+                return x < y;
+            });
+        }
+        catch(const std::runtime_error &) {}
+
+        // Between them the two lists still hold every element, and their
+        // sizes match their links
+        std::vector<int> all;
+        for(List<int> * ll : {&a, &b}) {
+            std::vector<int> forward(ll->begin(), ll->end());
+            std::vector<int> backward(std::make_reverse_iterator(ll->end()), std::make_reverse_iterator(ll->begin()));
+            std::reverse(backward.begin(), backward.end());
+            ASSERT_EQ(forward.size(), ll->size());
+            ASSERT_TRUE(forward == backward);
+            all.insert(all.end(), forward.begin(), forward.end());
+        }
+        std::sort(all.begin(), all.end());
+        std::sort(gt.begin(), gt.end());
+        ASSERT_TRUE(all == gt);
+    }
+}
@@ -0,0 +1,125 @@
+#include "executable.h"
+#include "box.h"
+#include <list>
+#include <memory>
+
+TEST(node_pool_bulk_construct) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = i == 0 ? 0 : t.range<size_t>(1000);
+        const int value = t.get<int>();
+
+        auto pool = std::make_shared<List<int>::node_pool>();
+
+        Memhook mh;
+        List<int> ll(sz, value, pool);
+
+        // Every node comes out of one slab
+        ASSERT_EQ(sz ? 1ULL : 0ULL, mh.n_allocs());
+        ASSERT_EQ(sz, ll.size());
+        for(int x : ll)
+            ASSERT_EQ(value, x);
+
+        // So does every node of a copy, plus its own pool
+        List<int> copy(ll);
+        ASSERT_EQ(sz ? 1ULL + 2 : 1ULL, mh.n_allocs());
+        ASSERT_EQ(sz, copy.size());
+        for(int x : copy)
+            ASSERT_EQ(value, x);
+    }
+}
+
+TEST(node_pool_reuse_and_clear) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 500);
+        const size_t slab = t.range<size_t>(1, 64);
+
+        List<Box<int>> ll(std::make_shared<List<Box<int>>::node_pool>(slab));
+        std::list<int> gt;
+
+        Memhook mh;
+        for(size_t j = 0; j < sz; j++) {
+            int v = t.get<int>();
+            ll.push_back(Box<int>(v));
+            gt.push_back(v);
+        }
+
+        // One slab per slab nodes, plus one Box and one std::list node each
+        ASSERT_EQ((sz + slab - 1) / slab + 2 * sz, mh.n_allocs());
+
+        // Erased nodes are handed out again before any new slab
+        size_t erased = 0;
+        for(auto it = ll.begin(); it != ll.end(); erased++)
+            it = ll.erase(it);
+        gt.clear();
+        size_t allocs = mh.n_allocs();
+        for(size_t j = 0; j < erased; j++) {
+            int v = t.get<int>();
+            ll.push_front(Box<int>(v));
+            gt.push_front(v);
+        }
+        ASSERT_EQ(allocs + 2 * erased, mh.n_allocs());
+
+        auto gt_it = gt.begin();
+        for(auto it = ll.begin(); it != ll.end(); ++it, ++gt_it)
+            ASSERT_EQ(*gt_it, **it);
+
+        // The only user of the pool drops its slabs whole
+        size_t frees = mh.n_frees();
+        ll.clear();
+        ASSERT_EQ(frees + sz + (sz + slab - 1) / slab, mh.n_frees());
+        ASSERT_TRUE(ll.empty());
+        ASSERT_TRUE(ll.begin() == ll.end());
+
+        // And can be used again
+        ll.push_back(Box<int>(1));
+        ASSERT_EQ(1, *ll.front());
+    }
+}
+
+TEST(node_pool_shared) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        auto pool = std::make_shared<List<int>::node_pool>(t.range<size_t>(1, 32));
+        List<int> a(pool), b(pool);
+        std::list<int> gt_a, gt_b;
+
+        for(size_t j = 0; j < 200; j++) {
+            int v = t.get<int>();
+            bool first = t.range<int>(0, 2);
+            List<int> & ll = first ? a : b;
+            std::list<int> & gt = first ? gt_a : gt_b;
+            if(!gt.empty() && t.range<int>(0, 3) == 0) {
+                ll.pop_front();
+                gt.pop_front();
+            }
+            else {
+                ll.push_back(v);
+                gt.push_back(v);
+            }
+        }
+
+        // Clearing one list must leave the other's nodes alone
+        a.clear();
+        gt_a.clear();
+        ASSERT_TRUE(a.empty());
+        for(size_t j = 0; j < 50; j++) {
+            int v = t.get<int>();
+            a.push_front(v);
+            gt_a.push_front(v);
+        }
+
+        ASSERT_EQ(gt_a.size(), a.size());
+        ASSERT_EQ(gt_b.size(), b.size());
+        ASSERT_TRUE(std::equal(gt_a.begin(), gt_a.end(), a.begin()));
+        ASSERT_TRUE(std::equal(gt_b.begin(), gt_b.end(), b.begin()));
+
+        // Moving takes the pool along with the nodes
+        List<int> c(std::move(b));
+        ASSERT_TRUE(std::equal(gt_b.begin(), gt_b.end(), c.begin()));
+        a = std::move(c);
+        ASSERT_TRUE(std::equal(gt_b.begin(), gt_b.end(), a.begin()));
+        ASSERT_EQ(gt_b.size(), a.size());
+    }
+}
@@ -0,0 +1,56 @@
+#include "executable.h"
+#include <algorithm>
+#include <list>
+
+TEST(reverse) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = i == 0 ? 0 : t.range<size_t>(200);
+        List<int> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < sz; j++) {
+            int v = t.get<int>();
+            ll.push_back(v);
+            gt.push_back(v);
+        }
+
+        ll.reverse();
+        gt.reverse();
+        ASSERT_EQ(gt.size(), ll.size());
+        ASSERT_TRUE(std::equal(gt.begin(), gt.end(), ll.begin()));
+        ASSERT_TRUE(std::equal(gt.rbegin(), gt.rend(), std::make_reverse_iterator(ll.end())));
+
+        // Still usable at both ends
+        ll.push_front(1);
+        ll.push_back(2);
+        ASSERT_EQ(1, ll.front());
+        ASSERT_EQ(2, ll.back());
+    }
+}
+
+TEST(unique) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = i == 0 ? 0 : t.range<size_t>(200);
+        List<int> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < sz; j++) {
+            int v = t.range<int>(0, 4);
+            ll.push_back(v);
+            gt.push_back(v);
+        }
+
+        size_t before = gt.size();
+        gt.unique();
+        ASSERT_EQ(before - gt.size(), ll.unique());
+        ASSERT_EQ(gt.size(), ll.size());
+        ASSERT_TRUE(std::equal(gt.begin(), gt.end(), ll.begin()));
+
+        // With a predicate: runs whose values differ by at most one
+        std::list<int> gt2(gt.begin(), gt.end());
+        gt2.unique([](int a, int b) { return b - a <= 1 && a - b <= 1; });
+        ll.unique([](int a, int b) { return b - a <= 1 && a - b <= 1; });
+        ASSERT_EQ(gt2.size(), ll.size());
+        ASSERT_TRUE(std::equal(gt2.begin(), gt2.end(), ll.begin()));
+    }
+}
@@ -0,0 +1,115 @@
+#include "executable.h"
+#include "box.h"
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <vector>
+
+TEST(sort) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = i == 0 ? 0 : t.range<size_t>(2000);
+        List<int> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < sz; j++) {
+            int v = t.range<int>(0, 100);
+            ll.push_back(v);
+            gt.push_back(v);
+        }
+
+        Memhook mh;
+        ll.sort();
+        ASSERT_EQ(0ULL, mh.n_allocs());
+        gt.sort();
+
+        ASSERT_EQ(gt.size(), ll.size());
+        ASSERT_TRUE(std::equal(gt.begin(), gt.end(), ll.begin()));
+        ASSERT_TRUE(std::equal(gt.rbegin(), gt.rend(), std::make_reverse_iterator(ll.end())));
+
+        // Descending with a comparator
+        ll.sort([](int a, int b) { return a > b; });
+        ASSERT_TRUE(std::equal(gt.rbegin(), gt.rend(), ll.begin()));
+    }
+}
+
+TEST(sort_stable_and_relinks) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1000);
+        List<std::pair<int, size_t>> ll;
+        std::list<std::pair<int, size_t>> gt;
+        for(size_t j = 0; j < sz; j++) {
+            int key = t.range<int>(0, 10);
+            ll.push_back({key, j});
+            gt.push_back({key, j});
+        }
+        auto by_key = [](const std::pair<int, size_t> & a, const std::pair<int, size_t> & b) {
+            return a.first < b.first;
+        };
+        ll.sort(by_key);
+        gt.sort(by_key);
+        ASSERT_TRUE(std::equal(gt.begin(), gt.end(), ll.begin()));
+    }
+
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 200);
+        List<Box<int>> ll;
+        for(size_t j = 0; j < sz; j++)
+            ll.push_back(Box<int>(t.get<int>()));
+
+        // Elements keep their addresses and are never copied
+        std::vector<const Box<int> *> before;
+        for(const Box<int> & b : ll)
+            before.push_back(&b);
+        Memhook mh;
+        ll.sort([](const Box<int> & a, const Box<int> & b) { return *a < *b; });
+        ASSERT_EQ(0ULL, mh.n_allocs());
+
+        std::vector<const Box<int> *> after;
+        for(const Box<int> & b : ll)
+            after.push_back(&b);
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        ASSERT_TRUE(before == after);
+        ASSERT_TRUE(std::is_sorted(ll.begin(), ll.end(), [](const Box<int> & a, const Box<int> & b) { return *a < *b; }));
+    }
+}
+
+TEST(sort_throwing_comparator) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(2, 500);
+        List<int> ll;
+        std::vector<int> gt;
+        for(size_t j = 0; j < sz; j++) {
+            gt.push_back(t.range<int>(0, 100));
+            ll.push_back(gt.back());
+        }
+
+        size_t calls = t.range<size_t>(sz * 4);
+        bool threw = false;
+        try {
+            ll.sort([&calls](int a, int b) {
+                if(calls-- == 0)
+                    throw std::runtime_error("comparator");
+                return a < b;
+            });
+        }
+        catch(const std::runtime_error &) {
+            threw = true;
+        }
+
+        // Whether or not it finished, every element is still linked in
+        std::vector<int> forward(ll.begin(), ll.end());
+        std::vector<int> backward(std::make_reverse_iterator(ll.end()), std::make_reverse_iterator(ll.begin()));
+        std::reverse(backward.begin(), backward.end());
+        ASSERT_EQ(sz, ll.size());
+        ASSERT_EQ(sz, forward.size());
+        ASSERT_TRUE(forward == backward);
+        std::sort(forward.begin(), forward.end());
+        std::sort(gt.begin(), gt.end());
+        ASSERT_TRUE(forward == gt);
+        if(!threw)
+            ASSERT_TRUE(std::is_sorted(ll.begin(), ll.end()));
+    }
+}
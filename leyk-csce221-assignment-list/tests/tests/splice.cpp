@@ -0,0 +1,133 @@
+#include "executable.h"
+#include "box.h"
+#include <algorithm>
+#include <list>
+#include <memory>
+
+namespace {
+    bool matches(const std::list<int> & gt, const List<int> & ll) {
+        if(gt.size() != ll.size())
+            return false;
+        if(!std::equal(gt.begin(), gt.end(), ll.begin()))
+            return false;
+        auto gt_it = gt.end();
+        auto it = ll.end();
+        while(gt_it != gt.begin())
+            if(*--gt_it != *--it)
+                return false;
+        return true;
+    }
+
+    void fill(Typegen & t, List<int> & ll, std::list<int> & gt, size_t sz) {
+        for(size_t i = 0; i < sz; i++) {
+            int v = t.get<int>();
+            ll.push_back(v);
+            gt.push_back(v);
+        }
+    }
+}
+
+TEST(splice_other_list) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        List<int> a, b;
+        std::list<int> gt_a, gt_b;
+        fill(t, a, gt_a, t.range<size_t>(50));
+        fill(t, b, gt_b, t.range<size_t>(50));
+
+        Memhook mh;
+        switch(t.range<int>(0, 3)) {
+            case 0: {
+                size_t pos = t.range<size_t>(gt_a.size() + 1);
+                a.splice(std::next(a.begin(), pos), b);
+                gt_a.splice(std::next(gt_a.begin(), pos), gt_b);
+                break;
+            }
+            case 1: {
+                if(gt_b.empty())
+                    break;
+                size_t pos = t.range<size_t>(gt_a.size() + 1);
+                size_t it = t.range<size_t>(gt_b.size());
+                a.splice(std::next(a.begin(), pos), b, std::next(b.begin(), it));
+                gt_a.splice(std::next(gt_a.begin(), pos), gt_b, std::next(gt_b.begin(), it));
+                break;
+            }
+            default: {
+                size_t pos = t.range<size_t>(gt_a.size() + 1);
+                size_t first = t.range<size_t>(gt_b.size() + 1);
+                size_t last = t.range<size_t>(first, gt_b.size() + 1);
+                a.splice(std::next(a.begin(), pos), b, std::next(b.begin(), first), std::next(b.begin(), last));
+                gt_a.splice(std::next(gt_a.begin(), pos), gt_b, std::next(gt_b.begin(), first), std::next(gt_b.begin(), last));
+            }
+        }
+        // Only std::list may allocate or free
+        ASSERT_EQ(0ULL, mh.n_frees());
+
+        ASSERT_TRUE(matches(gt_a, a));
+        ASSERT_TRUE(matches(gt_b, b));
+    }
+}
+
+TEST(splice_same_list) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        List<int> ll;
+        std::list<int> gt;
+        fill(t, ll, gt, t.range<size_t>(1, 50));
+
+        // Move [first, last) to pos, which lies outside of it
+        size_t first = t.range<size_t>(gt.size());
+        size_t last = t.range<size_t>(first + 1, gt.size() + 1);
+        size_t pos = first > 0 && t.range<int>(0, 2) ? t.range<size_t>(first) : t.range<size_t>(last, gt.size() + 1);
+
+        Memhook mh;
+        ll.splice(std::next(ll.begin(), pos), ll, std::next(ll.begin(), first), std::next(ll.begin(), last));
+        gt.splice(std::next(gt.begin(), pos), gt, std::next(gt.begin(), first), std::next(gt.begin(), last));
+        ASSERT_EQ(0ULL, mh.n_allocs());
+        ASSERT_TRUE(matches(gt, ll));
+
+        // A single element, possibly onto itself
+        size_t it = t.range<size_t>(gt.size());
+        pos = t.range<size_t>(gt.size() + 1);
+        ll.splice(std::next(ll.begin(), pos), ll, std::next(ll.begin(), it));
+        gt.splice(std::next(gt.begin(), pos), gt, std::next(gt.begin(), it));
+        ASSERT_TRUE(matches(gt, ll));
+    }
+}
+
+TEST(splice_keeps_nodes) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1, 50);
+        List<Box<int>> a, b(sz, Box<int>(t.get<int>()));
+
+        // Spliced elements are the very same objects, not copies
+        const Box<int> * first = &b.front();
+        a.splice(a.end(), std::move(b));
+        ASSERT_EQ(first, &a.front());
+        ASSERT_EQ(sz, a.size());
+        ASSERT_TRUE(b.empty());
+        ASSERT_TRUE(b.begin() == b.end());
+    }
+}
+
+TEST(splice_between_pools) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        List<int> a(std::make_shared<List<int>::node_pool>());
+        List<int> b;
+        std::list<int> gt_a, gt_b;
+        fill(t, a, gt_a, t.range<size_t>(50));
+        fill(t, b, gt_b, t.range<size_t>(50));
+
+        size_t pos = t.range<size_t>(gt_a.size() + 1);
+        a.splice(std::next(a.begin(), pos), b);
+        gt_a.splice(std::next(gt_a.begin(), pos), gt_b);
+        ASSERT_TRUE(matches(gt_a, a));
+        ASSERT_TRUE(b.empty());
+
+        // Each list still frees its nodes the way they were allocated
+        a.clear();
+        b.push_back(1);
+    }
+}
@@ -0,0 +1,160 @@
+#include "executable.h"
+#include "box.h"
+#include "UnrolledList.h"
+#include <algorithm>
+#include <list>
+#include <type_traits>
+
+// Iterators only convert towards const
+static_assert(std::is_convertible<UnrolledList<int>::iterator, UnrolledList<int>::const_iterator>::value, "");
+static_assert(!std::is_convertible<UnrolledList<int>::const_iterator, UnrolledList<int>::iterator>::value, "");
+
+namespace {
+    template <class List>
+    bool matches(const std::list<int> & gt, const List & ll) {
+        if(gt.size() != ll.size())
+            return false;
+        if(!std::equal(gt.begin(), gt.end(), ll.begin(), ll.end()))
+            return false;
+        // Backward as well
+        auto gt_it = gt.end();
+        auto it = ll.end();
+        while(gt_it != gt.begin())
+            if(*--gt_it != *--it)
+                return false;
+        return it == ll.begin();
+    }
+}
+
+TEST(unrolled_list_push_pop) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1000);
+
+        Memhook mh;
+        UnrolledList<int, 8> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < sz; j++) {
+            int v = t.get<int>();
+            if(t.range<int>(0, 2)) {
+                ll.push_back(v);
+                gt.push_back(v);
+            }
+            else {
+                ll.push_front(v);
+                gt.push_front(v);
+            }
+        }
+        ASSERT_TRUE(matches(gt, ll));
+        if(sz) {
+            ASSERT_EQ(gt.front(), ll.front());
+            ASSERT_EQ(gt.back(), ll.back());
+        }
+
+        // One std::list node per element, but pushing at the ends keeps
+        // every node of ours except the two outermost full
+        ASSERT_LE(mh.n_allocs(), sz + sz / 8 + 2);
+
+        while(!gt.empty()) {
+            if(t.range<int>(0, 2)) {
+                ll.pop_back();
+                gt.pop_back();
+            }
+            else {
+                ll.pop_front();
+                gt.pop_front();
+            }
+        }
+        ASSERT_TRUE(ll.empty());
+        ASSERT_TRUE(ll.begin() == ll.end());
+        ASSERT_EQ(mh.n_allocs(), mh.n_frees());
+    }
+}
+
+TEST(unrolled_list_node_count) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(1000);
+        UnrolledList<int, 16> ll;
+
+        Memhook mh;
+        for(size_t j = 0; j < sz; j++)
+            ll.push_back(int(j));
+        ASSERT_EQ((sz + 15) / 16, mh.n_allocs());
+    }
+}
+
+TEST(unrolled_list_insert_erase) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t ops = t.range<size_t>(1000);
+
+        UnrolledList<int, 5> ll;
+        std::list<int> gt;
+        for(size_t j = 0; j < ops; j++) {
+            size_t pos = t.range<size_t>(gt.size() + 1);
+            auto it = std::next(ll.begin(), pos);
+            auto gt_it = std::next(gt.begin(), pos);
+            if(pos < gt.size() && t.range<int>(0, 3) == 0) {
+                it = ll.erase(it);
+                gt_it = gt.erase(gt_it);
+            }
+            else {
+                int v = t.get<int>();
+                it = ll.insert(it, v);
+                gt_it = gt.insert(gt_it, v);
+            }
+            // Both return an iterator to the same position
+            ASSERT_EQ(std::distance(gt.begin(), gt_it), std::distance(ll.begin(), it));
+            if(gt_it != gt.end())
+                ASSERT_EQ(*gt_it, *it);
+        }
+        ASSERT_TRUE(matches(gt, ll));
+
+        // Erasing everything from the middle outwards merges nodes as it goes
+        while(!gt.empty()) {
+            size_t pos = t.range<size_t>(gt.size());
+            ll.erase(std::next(ll.begin(), pos));
+            gt.erase(std::next(gt.begin(), pos));
+        }
+        ASSERT_TRUE(matches(gt, ll));
+    }
+}
+
+TEST(unrolled_list_copy_move) {
+    Typegen t;
+    for(size_t i = 0; i < TEST_ITER; i++) {
+        size_t sz = t.range<size_t>(300);
+
+        Memhook mh;
+        {
+            UnrolledList<Box<int>, 4> ll;
+            std::list<int> gt;
+            for(size_t j = 0; j < sz; j++) {
+                int v = t.get<int>();
+                ll.insert(std::next(ll.begin(), t.range<size_t>(ll.size() + 1)), Box<int>(v));
+            }
+            for(const Box<int> & b : ll)
+                gt.push_back(*b);
+
+            UnrolledList<Box<int>, 4> copy(ll);
+            UnrolledList<Box<int>, 4> moved(std::move(ll));
+            ASSERT_TRUE(ll.empty());
+            ASSERT_EQ(sz, moved.size());
+
+            auto gt_it = gt.begin();
+            for(auto it = copy.begin(); it != copy.end(); ++it, ++gt_it)
+                ASSERT_EQ(*gt_it, **it);
+            gt_it = gt.begin();
+            for(auto it = moved.cbegin(); it != moved.cend(); ++it, ++gt_it)
+                ASSERT_EQ(*gt_it, **it);
+
+            ll = copy;
+            copy = std::move(moved);
+            ASSERT_EQ(sz, ll.size());
+            ASSERT_EQ(sz, copy.size());
+            ASSERT_TRUE(moved.empty());
+        }
+        ASSERT_EQ(mh.n_allocs(), mh.n_frees());
+    }
+}
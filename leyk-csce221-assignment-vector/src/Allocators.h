@@ -0,0 +1,438 @@
+#ifndef ALLOCATORS_H
+#define ALLOCATORS_H
+
+#include <cstddef> // size_t, std::max_align_t
+#include <cstdint> // uintptr_t
+#include <new> // ::operator new, std::bad_alloc
+#include <type_traits> // std::true_type, std::false_type
+
+/*
+    Allocators for Vector<T, Alloc>
+    -------------------------------
+
+    ArenaAllocator and PoolAllocator follow the standard allocator model and
+    are thin handles to a resource (an Arena or a Pool) which owns the actual
+    memory. Copies of a handle share the resource and compare equal, so
+    Vectors built on the same resource can move buffers between each other
+    freely. The resource must outlive every Vector that draws from it.
+
+    RecyclingAllocator needs no resource: it draws from the calling thread's
+    BufferCache, so freed buffers are handed to the next Vector on that
+    thread which grows into the same size class.
+
+    Example:
+    {
+        Arena arena;
+
+        Vector<int, ArenaAllocator<int>> a{ArenaAllocator<int>(arena)};
+        a.push_back(1); // bump allocated from the arena
+
+        // ...
+
+        arena.release(); // (or let it go out of scope) frees everything at once
+    }
+*/
+
+// A monotonic arena: memory is handed out by bumping a pointer through large
+// blocks and is only ever returned all at once by release() or destruction.
+// Individual deallocations are ignored.
+class Arena {
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    Block* blocks;
+    char* cursor;
+    char* limit;
+    size_t next_block_size;
+
+    static constexpr size_t header_size = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    void add_block(size_t min_size) {
+        size_t size = next_block_size;
+        while (size < min_size + header_size) {
+            size *= 2;
+        }
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->next = blocks;
+        block->size = size;
+        blocks = block;
+        cursor = reinterpret_cast<char*>(block) + header_size;
+        limit = reinterpret_cast<char*>(block) + size;
+        // Geometric block sizes keep the number of blocks logarithmic
+        next_block_size = size * 2;
+    }
+
+public:
+    static constexpr size_t default_block_size = 64 * 1024;
+
+    explicit Arena(size_t block_size = default_block_size) noexcept
+    : blocks(nullptr), cursor(nullptr), limit(nullptr), next_block_size(block_size < 2 * header_size ? 2 * header_size : block_size) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {
+        release();
+    }
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        if (cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+            add_block(bytes + alignment);
+            aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        }
+        cursor = reinterpret_cast<char*>(aligned + bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+    void deallocate(void*, size_t) noexcept {}
+
+    // Frees every block. Anything allocated from the arena is invalidated.
+    void release() noexcept {
+        while (blocks != nullptr) {
+            Block* next = blocks->next;
+            ::operator delete(blocks);
+            blocks = next;
+        }
+        cursor = nullptr;
+        limit = nullptr;
+    }
+
+    // Number of bytes reserved from the global allocator
+    size_t reserved() const noexcept {
+        size_t total = 0;
+        for (Block* block = blocks; block != nullptr; block = block->next) {
+            total += block->size;
+        }
+        return total;
+    }
+};
+
+// A pool of power-of-two size classes. Freed chunks go onto an intrusive free
+// list for their class and are reused by the next allocation of that class.
+// Chunks are carved out of large slabs which are only returned to the global
+// allocator when the pool is released or destroyed. Requests larger than the
+// biggest class go straight to the global allocator.
+class Pool {
+    struct Chunk {
+        Chunk* next;
+    };
+    struct Slab {
+        Slab* next;
+    };
+
+public:
+    static constexpr size_t min_class_size = 16;
+    static constexpr size_t n_classes = 9; // 16 bytes .. 4 KiB
+    static constexpr size_t max_class_size = min_class_size << (n_classes - 1);
+    static constexpr size_t default_slab_size = 64 * 1024;
+
+private:
+    static constexpr size_t slab_header = (sizeof(Slab) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    Chunk* free_lists[n_classes];
+    Slab* slabs;
+    size_t slab_size;
+
+    static size_t class_of(size_t bytes) noexcept {
+        size_t index = 0;
+        size_t size = min_class_size;
+        while (size < bytes) {
+            size *= 2;
+            index++;
+        }
+        return index;
+    }
+
+    // Carves a fresh slab into chunks for the given class
+    void refill(size_t index) {
+        size_t chunk_size = min_class_size << index;
+        Slab* slab = static_cast<Slab*>(::operator new(slab_size));
+        slab->next = slabs;
+        slabs = slab;
+        char* first = reinterpret_cast<char*>(slab) + slab_header;
+        char* last = reinterpret_cast<char*>(slab) + slab_size;
+        for (char* chunk = first; chunk + chunk_size <= last; chunk += chunk_size) {
+            Chunk* node = reinterpret_cast<Chunk*>(chunk);
+            node->next = free_lists[index];
+            free_lists[index] = node;
+        }
+    }
+
+public:
+    explicit Pool(size_t slab_size = default_slab_size) noexcept
+    : free_lists(), slabs(nullptr), slab_size(slab_size < slab_header + max_class_size ? slab_header + max_class_size : slab_size) {}
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    ~Pool() {
+        release();
+    }
+
+    void* allocate(size_t bytes) {
+        if (bytes > max_class_size) {
+            return ::operator new(bytes);
+        }
+        size_t index = class_of(bytes);
+        if (free_lists[index] == nullptr) {
+            refill(index);
+        }
+        Chunk* chunk = free_lists[index];
+        free_lists[index] = chunk->next;
+        return chunk;
+    }
+    void deallocate(void* ptr, size_t bytes) noexcept {
+        if (bytes > max_class_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        size_t index = class_of(bytes);
+        Chunk* chunk = static_cast<Chunk*>(ptr);
+        chunk->next = free_lists[index];
+        free_lists[index] = chunk;
+    }
+
+    // Frees every slab. Pooled allocations are invalidated, but large
+    // allocations which bypassed the pool must still be deallocated.
+    void release() noexcept {
+        while (slabs != nullptr) {
+            Slab* next = slabs->next;
+            ::operator delete(slabs);
+            slabs = next;
+        }
+        for (size_t i = 0; i < n_classes; i++) {
+            free_lists[i] = nullptr;
+        }
+    }
+};
+
+// A per-thread cache of recently freed buffers, in power-of-two size
+// classes from 16 bytes to 64 MiB. Up to max_per_class buffers of each class
+// are kept and the rest go back to the global allocator, as do requests
+// larger than the biggest class. Every buffer is freed when its thread exits;
+// after that alive() is false and the thread's late frees (say, from static
+// Vectors) must go straight to the global allocator.
+class BufferCache {
+    struct Buffer {
+        Buffer* next;
+    };
+
+public:
+    static constexpr size_t min_class_size = 16;
+    static constexpr size_t n_classes = 23; // 16 bytes .. 64 MiB
+    static constexpr size_t max_class_size = min_class_size << (n_classes - 1);
+    static constexpr size_t max_per_class = 8;
+
+private:
+    Buffer* free_lists[n_classes];
+    size_t counts[n_classes];
+    size_t _hits, _misses, _cached_bytes;
+
+    // Only for bytes <= max_class_size
+    static size_t class_of(size_t bytes) noexcept {
+        size_t index = 0;
+        size_t size = min_class_size;
+        while (size < bytes) {
+            size *= 2;
+            index++;
+        }
+        return index;
+    }
+
+    // Trivially destructible, so still readable once the cache is gone
+    static bool& destroyed() noexcept {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    BufferCache() noexcept : free_lists(), counts(), _hits(0), _misses(0), _cached_bytes(0) {}
+
+public:
+    BufferCache(const BufferCache&) = delete;
+    BufferCache& operator=(const BufferCache&) = delete;
+    ~BufferCache() {
+        release();
+        destroyed() = true;
+    }
+
+    // The calling thread's cache
+    static BufferCache& local() noexcept {
+        static thread_local BufferCache cache;
+        return cache;
+    }
+    // Whether local() may still be used on the calling thread
+    static bool alive() noexcept {
+        return !destroyed();
+    }
+
+    void* allocate(size_t bytes) {
+        if (bytes > max_class_size) {
+            _misses++;
+            return ::operator new(bytes);
+        }
+        size_t index = class_of(bytes);
+        if (free_lists[index] == nullptr) {
+            _misses++;
+            return ::operator new(min_class_size << index);
+        }
+        _hits++;
+        Buffer* buffer = free_lists[index];
+        free_lists[index] = buffer->next;
+        counts[index]--;
+        _cached_bytes -= min_class_size << index;
+        return buffer;
+    }
+    void deallocate(void* ptr, size_t bytes) noexcept {
+        if (bytes > max_class_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        size_t index = class_of(bytes);
+        if (counts[index] == max_per_class) {
+            ::operator delete(ptr);
+            return;
+        }
+        Buffer* buffer = static_cast<Buffer*>(ptr);
+        buffer->next = free_lists[index];
+        free_lists[index] = buffer;
+        counts[index]++;
+        _cached_bytes += min_class_size << index;
+    }
+
+    // Allocations served from the cache and from the global allocator
+    size_t hits() const noexcept {
+        return _hits;
+    }
+    size_t misses() const noexcept {
+        return _misses;
+    }
+    size_t cached_bytes() const noexcept {
+        return _cached_bytes;
+    }
+    void reset_counters() noexcept {
+        _hits = 0;
+        _misses = 0;
+    }
+
+    // Hands every cached buffer back to the global allocator
+    void release() noexcept {
+        for (size_t i = 0; i < n_classes; i++) {
+            while (free_lists[i] != nullptr) {
+                Buffer* next = free_lists[i]->next;
+                ::operator delete(free_lists[i]);
+                free_lists[i] = next;
+            }
+            counts[i] = 0;
+        }
+        _cached_bytes = 0;
+    }
+};
+
+template <class T>
+class ArenaAllocator {
+    template <class U>
+    friend class ArenaAllocator;
+
+    Arena* arena;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        arena->deallocate(ptr, count * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena == other.arena;
+    }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena != other.arena;
+    }
+};
+
+template <class T>
+class PoolAllocator {
+    template <class U>
+    friend class PoolAllocator;
+
+    Pool* pool;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit PoolAllocator(Pool& pool) noexcept : pool(&pool) {}
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.pool) {}
+
+    T* allocate(size_t count) {
+        static_assert(alignof(T) <= Pool::min_class_size, "Pool chunks are only aligned to the smallest size class");
+        return static_cast<T*>(pool->allocate(count * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        pool->deallocate(ptr, count * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool == other.pool;
+    }
+    template <class U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept {
+        return pool != other.pool;
+    }
+};
+
+// Stateless, so any two compare equal and buffers may be freed on a
+// different thread from the one that allocated them (they then join that
+// thread's cache)
+template <class T>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    RecyclingAllocator() noexcept = default;
+    template <class U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Cached buffers are only aligned for std::max_align_t");
+        if (!BufferCache::alive()) {
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<T*>(BufferCache::local().allocate(count * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (!BufferCache::alive()) {
+            ::operator delete(ptr);
+            return;
+        }
+        BufferCache::local().deallocate(ptr, count * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const RecyclingAllocator<U>&) const noexcept {
+        return true;
+    }
+    template <class U>
+    bool operator!=(const RecyclingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+#endif
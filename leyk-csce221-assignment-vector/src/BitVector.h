@@ -0,0 +1,472 @@
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include <algorithm> // std::min
+#include <cstddef> // size_t, ptrdiff_t
+#include <cstdint> // uint64_t
+#include <iterator> // std::random_access_iterator_tag
+#include <stdexcept> // std::out_of_range, std::invalid_argument
+#include <type_traits> // std::enable_if, std::is_convertible
+#include <utility> // std::move
+
+#include "Vector.h"
+
+/*
+    BitVector
+    ---------
+
+    A sequence of bools packed 64 to a word, with the usual Vector surface
+    (push_back, insert, erase, random access iterators) plus whole-word
+    operations: count() is a popcount per word, find_first()/find_next()
+    skip zero words, and &=, |=, ^= and flip() combine two bitmaps a word
+    at a time in loops the compiler vectorizes.
+
+    Bits past size() in the last word are always kept clear, so the word
+    operations never need to mask anything but the last word.
+
+    Since a bit has no address, indexing and iterators yield a
+    BitVector::reference proxy which converts to and assigns from bool.
+    The const ones (and const_iterator) yield plain bools.
+
+    Example:
+    {
+        BitVector visited(n_nodes, false);
+        visited[start] = true;
+
+        BitVector frontier = ...;
+        frontier &= ~visited;
+        for (size_t i = frontier.find_first(); i < frontier.size(); i = frontier.find_next(i)) {
+            ...
+        }
+    }
+*/
+class BitVector {
+    static constexpr size_t word_bits = 64;
+
+    Vector<uint64_t> words;
+    size_t _size;
+
+    static size_t words_for(size_t bits) noexcept {
+        return (bits + word_bits - 1) / word_bits;
+    }
+    static uint64_t low_mask(size_t n) noexcept {
+        return n >= word_bits ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+    }
+
+    // Reads n <= 64 bits starting at bit pos
+    uint64_t read_bits(size_t pos, size_t n) const noexcept {
+        size_t w = pos / word_bits, b = pos % word_bits;
+        uint64_t value = words[w] >> b;
+        if (b != 0 && b + n > word_bits) {
+            value |= words[w + 1] << (word_bits - b);
+        }
+        return value & low_mask(n);
+    }
+    // Overwrites n <= 64 bits starting at bit pos with the low bits of value
+    void write_bits(size_t pos, size_t n, uint64_t value) noexcept {
+        size_t w = pos / word_bits, b = pos % word_bits;
+        value &= low_mask(n);
+        uint64_t mask = low_mask(n) << b;
+        words[w] = (words[w] & ~mask) | (value << b);
+        if (b != 0 && b + n > word_bits) {
+            size_t spill = b + n - word_bits;
+            uint64_t high = low_mask(spill);
+            words[w + 1] = (words[w + 1] & ~high) | (value >> (word_bits - b));
+        }
+    }
+
+    // Makes room for count bits at idx by moving the tail up, a word at a time
+    void shift_up(size_t idx, size_t count) {
+        size_t old_size = _size;
+        resize(_size + count);
+        for (size_t end = old_size; end > idx;) {
+            size_t n = std::min(word_bits, end - idx);
+            end -= n;
+            write_bits(end + count, n, read_bits(end, n));
+        }
+    }
+    // Clears the bits past size() in the last word
+    void trim() noexcept {
+        if (_size % word_bits != 0) {
+            words[words.size() - 1] &= low_mask(_size % word_bits);
+        }
+    }
+    void check_same_size(const BitVector& other) const {
+        if (other._size != _size) {
+            throw std::invalid_argument("BitVector sizes differ");
+        }
+    }
+
+public:
+    template <class Owner, class Reference>
+    class basic_iterator;
+
+    // Stands in for a bool& to a single bit
+    class reference {
+        uint64_t* word;
+        uint64_t mask;
+    public:
+        reference(uint64_t* word, size_t bit) noexcept : word(word), mask(uint64_t(1) << bit) {}
+
+        operator bool() const noexcept {
+            return (*word & mask) != 0;
+        }
+        reference& operator=(bool value) noexcept {
+            if (value) {
+                *word |= mask;
+            }
+            else {
+                *word &= ~mask;
+            }
+            return *this;
+        }
+        reference& operator=(const reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+        void flip() noexcept {
+            *word ^= mask;
+        }
+    };
+
+    using iterator = basic_iterator<BitVector, reference>;
+    using const_iterator = basic_iterator<const BitVector, bool>;
+
+    BitVector() noexcept : _size(0) {}
+    BitVector(size_t count, bool value) : words(words_for(count), value ? ~uint64_t(0) : 0), _size(count) {
+        trim();
+    }
+    explicit BitVector(size_t count) : BitVector(count, false) {}
+    BitVector(const BitVector& other) = default;
+    BitVector(BitVector&& other) noexcept : words(std::move(other.words)), _size(other._size) {
+        other._size = 0;
+    }
+    BitVector& operator=(const BitVector& other) = default;
+    BitVector& operator=(BitVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        words = std::move(other.words);
+        _size = other._size;
+        other._size = 0;
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, _size);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, _size);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return _size == 0;
+    }
+    size_t size() const noexcept {
+        return _size;
+    }
+    size_t capacity() const noexcept {
+        return words.capacity() * word_bits;
+    }
+
+    bool at(size_t pos) const {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return (*this)[pos];
+    }
+    reference at(size_t pos) {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return (*this)[pos];
+    }
+    bool operator[](size_t pos) const noexcept {
+        return (words[pos / word_bits] >> (pos % word_bits)) & 1;
+    }
+    reference operator[](size_t pos) noexcept {
+        return reference(&words[pos / word_bits], pos % word_bits);
+    }
+    bool front() const noexcept {
+        return (*this)[0];
+    }
+    reference front() noexcept {
+        return (*this)[0];
+    }
+    bool back() const noexcept {
+        return (*this)[_size - 1];
+    }
+    reference back() noexcept {
+        return (*this)[_size - 1];
+    }
+
+    void reserve(size_t new_cap) {
+        words.reserve(words_for(new_cap));
+    }
+    void resize(size_t count, bool value = false) {
+        size_t old_size = _size;
+        words.resize(words_for(count), value ? ~uint64_t(0) : 0);
+        if (value && count > old_size && old_size % word_bits != 0) {
+            // Fill the rest of the old last word too
+            size_t n = std::min(count, words_for(old_size) * word_bits) - old_size;
+            write_bits(old_size, n, ~uint64_t(0));
+        }
+        _size = count;
+        trim();
+    }
+    void shrink_to_fit() {
+        words.shrink_to_fit();
+    }
+
+    void push_back(bool value) {
+        if (_size % word_bits == 0) {
+            words.push_back(0);
+        }
+        _size++;
+        (*this)[_size - 1] = value;
+    }
+    void pop_back() {
+        _size--;
+        (*this)[_size] = false;
+        if (_size % word_bits == 0) {
+            words.pop_back();
+        }
+    }
+
+    iterator insert(iterator pos, bool value) {
+        return insert(pos, 1, value);
+    }
+    iterator insert(iterator pos, size_t count, bool value) {
+        size_t idx = pos - begin();
+        shift_up(idx, count);
+        for (size_t i = idx; i < idx + count;) {
+            size_t n = std::min(word_bits, idx + count - i);
+            write_bits(i, n, value ? ~uint64_t(0) : 0);
+            i += n;
+        }
+        return begin() + idx;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    // Moves the tail down over the gap a word at a time
+    iterator erase(iterator first, iterator last) {
+        size_t idx = first - begin(), count = last - first;
+        for (size_t from = idx + count; from < _size;) {
+            size_t n = std::min(word_bits, _size - from);
+            write_bits(from - count, n, read_bits(from, n));
+            from += n;
+        }
+        resize(_size - count);
+        return begin() + idx;
+    }
+
+    // Keeps the words for reuse
+    void clear() noexcept {
+        words.clear();
+        _size = 0;
+    }
+
+    // Number of set bits
+    size_t count() const noexcept {
+        size_t total = 0;
+        for (size_t i = 0; i < words.size(); i++) {
+            total += __builtin_popcountll(words[i]);
+        }
+        return total;
+    }
+    bool any() const noexcept {
+        for (size_t i = 0; i < words.size(); i++) {
+            if (words[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool none() const noexcept {
+        return !any();
+    }
+    bool all() const noexcept {
+        return count() == _size;
+    }
+
+    // Index of the first set bit at or after pos, size() if there is none
+    size_t find_from(size_t pos) const noexcept {
+        if (pos >= _size) {
+            return _size;
+        }
+        size_t w = pos / word_bits;
+        uint64_t word = words[w] & ~low_mask(pos % word_bits);
+        while (word == 0) {
+            if (++w == words.size()) {
+                return _size;
+            }
+            word = words[w];
+        }
+        return w * word_bits + __builtin_ctzll(word);
+    }
+    size_t find_first() const noexcept {
+        return find_from(0);
+    }
+    size_t find_next(size_t pos) const noexcept {
+        return find_from(pos + 1);
+    }
+
+    // Word-wise combinations; both sides must be the same size
+    BitVector& operator&=(const BitVector& other) {
+        check_same_size(other);
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+    BitVector& operator|=(const BitVector& other) {
+        check_same_size(other);
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+    BitVector& operator^=(const BitVector& other) {
+        check_same_size(other);
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] ^= other.words[i];
+        }
+        return *this;
+    }
+    // Inverts every bit
+    BitVector& flip() noexcept {
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] = ~words[i];
+        }
+        trim();
+        return *this;
+    }
+    BitVector operator~() const {
+        BitVector result(*this);
+        return result.flip();
+    }
+
+    bool operator==(const BitVector& other) const noexcept {
+        if (_size != other._size) {
+            return false;
+        }
+        for (size_t i = 0; i < words.size(); i++) {
+            if (words[i] != other.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const BitVector& other) const noexcept {
+        return !(*this == other);
+    }
+
+    // Yields a reference proxy, or a plain bool for const_iterator
+    template <class Owner, class Reference>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = Reference;
+    private:
+        template <class, class>
+        friend class basic_iterator;
+
+        Owner* _owner;
+        size_t _pos;
+    public:
+        basic_iterator() noexcept : _owner(nullptr), _pos(0) {}
+        basic_iterator(Owner* owner, size_t pos) noexcept : _owner(owner), _pos(pos) {}
+        // iterator converts to const_iterator, not the other way around
+        template <class O, class R, typename std::enable_if<std::is_convertible<O*, Owner*>::value, int>::type = 0>
+        basic_iterator(const basic_iterator<O, R>& other) noexcept : _owner(other._owner), _pos(other._pos) {}
+
+        reference operator*() const noexcept {
+            return (*_owner)[_pos];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*_owner)[_pos + offset];
+        }
+
+        basic_iterator& operator++() noexcept {
+            _pos++;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator copy = *this;
+            _pos++;
+            return copy;
+        }
+        basic_iterator& operator--() noexcept {
+            _pos--;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator copy = *this;
+            _pos--;
+            return copy;
+        }
+        basic_iterator& operator+=(difference_type offset) noexcept {
+            _pos += offset;
+            return *this;
+        }
+        basic_iterator operator+(difference_type offset) const noexcept {
+            return basic_iterator(_owner, _pos + offset);
+        }
+        basic_iterator& operator-=(difference_type offset) noexcept {
+            _pos -= offset;
+            return *this;
+        }
+        basic_iterator operator-(difference_type offset) const noexcept {
+            return basic_iterator(_owner, _pos - offset);
+        }
+        difference_type operator-(const basic_iterator& rhs) const noexcept {
+            return static_cast<difference_type>(_pos) - static_cast<difference_type>(rhs._pos);
+        }
+
+        bool operator==(const basic_iterator& rhs) const noexcept {
+            return _pos == rhs._pos;
+        }
+        bool operator!=(const basic_iterator& rhs) const noexcept {
+            return _pos != rhs._pos;
+        }
+        bool operator<(const basic_iterator& rhs) const noexcept {
+            return _pos < rhs._pos;
+        }
+        bool operator>(const basic_iterator& rhs) const noexcept {
+            return _pos > rhs._pos;
+        }
+        bool operator<=(const basic_iterator& rhs) const noexcept {
+            return _pos <= rhs._pos;
+        }
+        bool operator>=(const basic_iterator& rhs) const noexcept {
+            return _pos >= rhs._pos;
+        }
+    };
+};
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs) {
+    return lhs &= rhs;
+}
+inline BitVector operator|(BitVector lhs, const BitVector& rhs) {
+    return lhs |= rhs;
+}
+inline BitVector operator^(BitVector lhs, const BitVector& rhs) {
+    return lhs ^= rhs;
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#include <atomic> // std::atomic, std::memory_order
+#include <cstddef> // size_t
+#include <new> // placement new
+#include <stdexcept> // std::out_of_range
+#include <utility> // std::move, std::forward
+
+/*
+    ConcurrentVector
+    ----------------
+
+    An append-only Vector that any number of threads can push to at once
+    without a lock. A push claims its index with one atomic fetch_add and
+    constructs the element in place, so appenders only contend on that
+    counter.
+
+    Elements live in buckets that double in size (FirstShift sets the first
+    one to 2^FirstShift slots) and are never moved or freed until the vector
+    is destroyed, so an element's address is stable. Buckets are allocated
+    on first use; when two threads race to allocate the same bucket, one
+    wins the compare-exchange and the other frees its copy.
+
+    Element i is published once published(i) is true, and from then on any
+    thread may read it. size() counts claimed slots, some of which may
+    still be under construction. clear() and destruction must not race with
+    anything else.
+
+    Example:
+    {
+        ConcurrentVector<Event> events;
+
+        // on every ingest thread
+        size_t idx = events.push_back(event);
+
+        // on a reader thread
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events.published(i)) {
+                handle(events[i]);
+            }
+        }
+    }
+*/
+template <class T, size_t FirstShift = 5>
+class ConcurrentVector {
+    static constexpr size_t bits = sizeof(size_t) * 8;
+    static_assert(FirstShift < bits, "First bucket does not fit in size_t");
+
+    struct Slot {
+        std::atomic<bool> ready;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    static constexpr size_t first_size = size_t(1) << FirstShift;
+    // Enough buckets to address every index a size_t can hold
+    static constexpr size_t n_buckets = bits - FirstShift;
+
+    std::atomic<Slot*> buckets[n_buckets];
+    std::atomic<size_t> _size;
+
+    static size_t bucket_size(size_t bucket) noexcept {
+        return first_size << bucket;
+    }
+    // Index i is offset (i + first_size) - 2^k into bucket k - FirstShift,
+    // where 2^k is the highest bit of i + first_size
+    static size_t bucket_of(size_t pos) noexcept {
+        return (bits - 1 - __builtin_clzl(pos + first_size)) - FirstShift;
+    }
+    static size_t offset_of(size_t pos, size_t bucket) noexcept {
+        return pos + first_size - bucket_size(bucket);
+    }
+
+    static Slot* make_bucket(size_t count) {
+        Slot* slots = static_cast<Slot*>(::operator new(count * sizeof(Slot)));
+        for (size_t i = 0; i < count; i++) {
+            new (&slots[i].ready) std::atomic<bool>(false);
+        }
+        return slots;
+    }
+
+    Slot* bucket(size_t b) {
+        Slot* slots = buckets[b].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        Slot* fresh = make_bucket(bucket_size(b));
+        if (buckets[b].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        // Another thread installed the bucket first
+        ::operator delete(fresh);
+        return slots;
+    }
+
+    Slot& slot(size_t pos) const noexcept {
+        size_t b = bucket_of(pos);
+        return buckets[b].load(std::memory_order_acquire)[offset_of(pos, b)];
+    }
+    // Like slot, but a claimed index may not have its bucket yet
+    Slot* find(size_t pos) const noexcept {
+        size_t b = bucket_of(pos);
+        Slot* slots = buckets[b].load(std::memory_order_acquire);
+        return slots == nullptr ? nullptr : slots + offset_of(pos, b);
+    }
+
+    // Destroys every published element. Not thread-safe.
+    void destroy() noexcept {
+        size_t sz = _size.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < sz; i++) {
+            Slot* s = find(i);
+            if (s != nullptr && s->ready.load(std::memory_order_relaxed)) {
+                s->value()->~T();
+                s->ready.store(false, std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    ConcurrentVector() noexcept : _size(0) {
+        for (std::atomic<Slot*>& b : buckets) {
+            b.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        destroy();
+        for (std::atomic<Slot*>& b : buckets) {
+            ::operator delete(b.load(std::memory_order_relaxed));
+        }
+    }
+
+    // Number of claimed slots, including any still being constructed
+    size_t size() const noexcept {
+        return _size.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+    // Whether element pos has finished constructing and may be read
+    bool published(size_t pos) const noexcept {
+        if (pos >= size()) {
+            return false;
+        }
+        Slot* s = find(pos);
+        return s != nullptr && s->ready.load(std::memory_order_acquire);
+    }
+
+    // Only valid for published elements
+    T& operator[](size_t pos) noexcept {
+        return *slot(pos).value();
+    }
+    const T& operator[](size_t pos) const noexcept {
+        return *slot(pos).value();
+    }
+    T& at(size_t pos) {
+        if (!published(pos)) {
+            throw std::out_of_range("error");
+        }
+        return *slot(pos).value();
+    }
+    const T& at(size_t pos) const {
+        if (!published(pos)) {
+            throw std::out_of_range("error");
+        }
+        return *slot(pos).value();
+    }
+
+    // Allocates the buckets for the first new_cap elements up front so
+    // appenders never have to. Safe to call concurrently with pushes.
+    void reserve(size_t new_cap) {
+        for (size_t b = 0; b < n_buckets && new_cap > bucket_size(b) - first_size; b++) {
+            bucket(b);
+        }
+    }
+
+    // Each returns the index the element was stored at. If the constructor
+    // throws the slot stays claimed but is never published.
+    size_t push_back(const T& value) {
+        return emplace_back(value);
+    }
+    size_t push_back(T&& value) {
+        return emplace_back(std::move(value));
+    }
+    template <class... Args>
+    size_t emplace_back(Args&&... args) {
+        size_t pos = _size.fetch_add(1, std::memory_order_relaxed);
+        size_t b = bucket_of(pos);
+        Slot& s = bucket(b)[offset_of(pos, b)];
+        new (s.storage) T(std::forward<Args>(args)...);
+        s.ready.store(true, std::memory_order_release);
+        return pos;
+    }
+
+    // Destroys the elements but keeps the buckets. Not thread-safe.
+    void clear() noexcept {
+        destroy();
+        _size.store(0, std::memory_order_relaxed);
+    }
+};
+
+#endif
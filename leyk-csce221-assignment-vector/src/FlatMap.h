@@ -0,0 +1,519 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <algorithm> // std::stable_sort, std::inplace_merge
+#include <cstddef> // size_t, ptrdiff_t
+#include <functional> // std::less
+#include <iterator> // std::random_access_iterator_tag
+#include <stdexcept> // std::out_of_range
+#include <type_traits> // std::enable_if, std::is_convertible, std::is_nothrow_move_constructible
+#include <utility> // std::pair, std::move, std::forward, std::move_if_noexcept
+
+#include "Vector.h"
+
+/*
+    FlatMap and FlatSet
+    -------------------
+
+    Ordered associative containers stored as sorted Vectors instead of tree
+    nodes. FlatMap keeps its keys and its values in two parallel Vectors,
+    so a lookup is a binary search over one contiguous array of keys and
+    iteration is a linear walk. Inserting or erasing a single entry shifts
+    the entries after it, so these suit tables that are built once (or
+    rarely) and read often.
+
+    Bulk loading has two fast paths:
+
+        insert(first, last)     appends the range, then sorts it and merges
+                                it with the existing entries once
+        insert_unsorted(...)    only appends; the pending entries are sorted
+                                and merged by the next call that reads
+
+    Keys are unique: when a key is inserted more than once, the entry that
+    was inserted first is kept, as with std::map::insert. Lookups use a
+    branchless lower bound.
+
+    Because a read may have to sort pending entries first, even the const
+    members may modify the container, so concurrent readers must not share
+    one with pending insert_unsorted entries. Sorting them builds new
+    Vectors and only moves entries into them when no move can throw, so a
+    throwing comparator, copy or allocation leaves the container as it was.
+
+    Example:
+    {
+        FlatMap<std::string, int> routes;
+        for (...) {
+            routes.insert_unsorted(prefix, port);   // O(1) each
+        }
+        int port = routes.at("10.0.0.0/8");         // sorts once, then searches
+    }
+*/
+
+namespace {
+    // Index of the first of the n keys that is not less than key. The loop
+    // always runs log2(n) times and the step is a conditional move.
+    template <class K, class Compare>
+    size_t branchless_lower_bound(const K* first, size_t n, const K& key, const Compare& comp) {
+        if (n == 0) {
+            return 0;
+        }
+        const K* base = first;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = comp(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return (base - first) + comp(*base, key);
+    }
+
+    // Orders the indices of keys[0, n) by key: the first sorted entries are
+    // already in order, the rest are sorted stably and merged after them.
+    // Of equal keys only the one inserted first is kept.
+    template <class K, class Compare>
+    Vector<size_t> merge_order(const Vector<K>& keys, size_t sorted, const Compare& comp) {
+        size_t n = keys.size();
+        Vector<size_t> order(n);
+        for (size_t i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        auto by_key = [&](size_t a, size_t b) { return comp(keys[a], keys[b]); };
+        size_t* data = &order[0];
+        std::stable_sort(data + sorted, data + n, by_key);
+        std::inplace_merge(data, data + sorted, data + n, by_key);
+        size_t kept = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (kept == 0 || comp(keys[data[kept - 1]], keys[data[i]])) {
+                data[kept++] = data[i];
+            }
+        }
+        order.resize(kept);
+        return order;
+    }
+}
+
+template <class K, class V, class Compare = std::less<K>>
+class FlatMap {
+public:
+    template <class Owner, class Value>
+    class basic_iterator;
+    using iterator = basic_iterator<FlatMap, V>;
+    using const_iterator = basic_iterator<const FlatMap, const V>;
+    using key_type = K;
+    using mapped_type = V;
+    using reference = std::pair<const K&, V&>;
+    using const_reference = std::pair<const K&, const V&>;
+
+private:
+    // keys[0, sorted) are sorted and unique, the rest await a merge
+    mutable Vector<K> keys;
+    mutable Vector<V> values;
+    mutable size_t sorted;
+    Compare comp;
+
+    bool equal(const K& a, const K& b) const {
+        return !comp(a, b) && !comp(b, a);
+    }
+
+    // Sorts and merges any pending entries, dropping repeated keys
+    void normalize() const {
+        if (sorted == keys.size()) {
+            return;
+        }
+        Vector<size_t> order = merge_order(keys, sorted, comp);
+        Vector<K> keys2;
+        Vector<V> values2;
+        keys2.reserve(order.size());
+        values2.reserve(order.size());
+        // Moving out is only safe when nothing after it can throw
+        constexpr bool move = std::is_nothrow_move_constructible<K>::value && std::is_nothrow_move_constructible<V>::value;
+        for (size_t i = 0; i < order.size(); i++) {
+            if constexpr (move) {
+                keys2.push_back(std::move(keys[order[i]]));
+                values2.push_back(std::move(values[order[i]]));
+            }
+            else {
+                keys2.push_back(keys[order[i]]);
+                values2.push_back(values[order[i]]);
+            }
+        }
+        keys = std::move(keys2);
+        values = std::move(values2);
+        sorted = keys.size();
+    }
+
+    size_t lower_index(const K& key) const {
+        normalize();
+        return branchless_lower_bound(keys.empty() ? nullptr : &keys[0], keys.size(), key, comp);
+    }
+    // Index of key, or size() if it is absent
+    size_t index_of(const K& key) const {
+        size_t idx = lower_index(key);
+        return idx < keys.size() && equal(keys[idx], key) ? idx : keys.size();
+    }
+    size_t upper_index(const K& key) const {
+        size_t idx = lower_index(key);
+        return idx < keys.size() && equal(keys[idx], key) ? idx + 1 : idx;
+    }
+
+public:
+    explicit FlatMap(const Compare& comp = Compare()) : sorted(0), comp(comp) {}
+
+    iterator begin() {
+        normalize();
+        return iterator(this, 0);
+    }
+    iterator end() {
+        normalize();
+        return iterator(this, keys.size());
+    }
+    const_iterator begin() const {
+        normalize();
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const {
+        normalize();
+        return const_iterator(this, keys.size());
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return keys.empty();
+    }
+    size_t size() const {
+        normalize();
+        return keys.size();
+    }
+    void reserve(size_t new_cap) {
+        keys.reserve(new_cap);
+        values.reserve(new_cap);
+    }
+
+    iterator find(const K& key) {
+        return iterator(this, index_of(key));
+    }
+    iterator lower_bound(const K& key) {
+        return iterator(this, lower_index(key));
+    }
+    iterator upper_bound(const K& key) {
+        return iterator(this, upper_index(key));
+    }
+    const_iterator find(const K& key) const {
+        return const_iterator(this, index_of(key));
+    }
+    const_iterator lower_bound(const K& key) const {
+        return const_iterator(this, lower_index(key));
+    }
+    const_iterator upper_bound(const K& key) const {
+        return const_iterator(this, upper_index(key));
+    }
+    bool contains(const K& key) const {
+        return index_of(key) != keys.size();
+    }
+    size_t count(const K& key) const {
+        return contains(key);
+    }
+
+    V& at(const K& key) {
+        size_t idx = index_of(key);
+        if (idx == keys.size()) {
+            throw std::out_of_range("error");
+        }
+        return values[idx];
+    }
+    const V& at(const K& key) const {
+        size_t idx = index_of(key);
+        if (idx == keys.size()) {
+            throw std::out_of_range("error");
+        }
+        return values[idx];
+    }
+    // Inserts a default constructed value if key is absent
+    V& operator[](const K& key) {
+        return insert(key, V()).first.value();
+    }
+
+    // Inserts (key, value) unless key is already present
+    std::pair<iterator, bool> insert(const K& key, const V& value) {
+        size_t idx = lower_index(key);
+        if (idx < keys.size() && equal(keys[idx], key)) {
+            return {iterator(this, idx), false};
+        }
+        keys.insert(keys.begin() + idx, key);
+        values.insert(values.begin() + idx, value);
+        sorted++;
+        return {iterator(this, idx), true};
+    }
+    std::pair<iterator, bool> insert_or_assign(const K& key, const V& value) {
+        std::pair<iterator, bool> result = insert(key, value);
+        if (!result.second) {
+            result.first.value() = value;
+        }
+        return result;
+    }
+    // Inserts every (key, value) pair of the range with one sort and merge
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            insert_unsorted((*first).first, (*first).second);
+        }
+        normalize();
+    }
+    // Appends without searching; sorted on the next read
+    void insert_unsorted(const K& key, const V& value) {
+        keys.push_back(key);
+        values.push_back(value);
+    }
+
+    size_t erase(const K& key) {
+        size_t idx = index_of(key);
+        if (idx == keys.size()) {
+            return 0;
+        }
+        erase(iterator(this, idx));
+        return 1;
+    }
+    iterator erase(iterator pos) {
+        size_t idx = pos.index();
+        keys.erase(keys.begin() + idx);
+        values.erase(values.begin() + idx);
+        sorted--;
+        return iterator(this, idx);
+    }
+
+    void clear() noexcept {
+        keys.clear();
+        values.clear();
+        sorted = 0;
+    }
+
+    // Yields std::pair<const K&, V&> (or const V& for const_iterator) for
+    // each entry in key order
+    template <class Owner, class Value>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+
+        // Lets it->first and it->second work on the proxy pair
+        struct pointer {
+            reference ref;
+            const reference* operator->() const noexcept {
+                return &ref;
+            }
+        };
+    private:
+        template <class, class>
+        friend class basic_iterator;
+
+        Owner* _owner;
+        size_t _pos;
+    public:
+        basic_iterator() noexcept : _owner(nullptr), _pos(0) {}
+        basic_iterator(Owner* owner, size_t pos) noexcept : _owner(owner), _pos(pos) {}
+        // iterator converts to const_iterator, not the other way around
+        template <class O, class W, typename std::enable_if<std::is_convertible<O*, Owner*>::value, int>::type = 0>
+        basic_iterator(const basic_iterator<O, W>& other) noexcept : _owner(other._owner), _pos(other._pos) {}
+
+        const K& key() const noexcept {
+            return _owner->keys[_pos];
+        }
+        Value& value() const noexcept {
+            return _owner->values[_pos];
+        }
+        size_t index() const noexcept {
+            return _pos;
+        }
+
+        reference operator*() const noexcept {
+            return reference(key(), value());
+        }
+        pointer operator->() const noexcept {
+            return pointer{**this};
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        basic_iterator& operator++() noexcept {
+            _pos++;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator copy = *this;
+            _pos++;
+            return copy;
+        }
+        basic_iterator& operator--() noexcept {
+            _pos--;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator copy = *this;
+            _pos--;
+            return copy;
+        }
+        basic_iterator& operator+=(difference_type offset) noexcept {
+            _pos += offset;
+            return *this;
+        }
+        basic_iterator operator+(difference_type offset) const noexcept {
+            return basic_iterator(_owner, _pos + offset);
+        }
+        basic_iterator& operator-=(difference_type offset) noexcept {
+            _pos -= offset;
+            return *this;
+        }
+        basic_iterator operator-(difference_type offset) const noexcept {
+            return basic_iterator(_owner, _pos - offset);
+        }
+        difference_type operator-(const basic_iterator& rhs) const noexcept {
+            return static_cast<difference_type>(_pos) - static_cast<difference_type>(rhs._pos);
+        }
+
+        bool operator==(const basic_iterator& rhs) const noexcept {
+            return _pos == rhs._pos;
+        }
+        bool operator!=(const basic_iterator& rhs) const noexcept {
+            return _pos != rhs._pos;
+        }
+        bool operator<(const basic_iterator& rhs) const noexcept {
+            return _pos < rhs._pos;
+        }
+        bool operator>(const basic_iterator& rhs) const noexcept {
+            return _pos > rhs._pos;
+        }
+        bool operator<=(const basic_iterator& rhs) const noexcept {
+            return _pos <= rhs._pos;
+        }
+        bool operator>=(const basic_iterator& rhs) const noexcept {
+            return _pos >= rhs._pos;
+        }
+    };
+};
+
+template <class K, class Compare = std::less<K>>
+class FlatSet {
+public:
+    // Elements are read-only, so a plain pointer into the sorted keys
+    using iterator = const K*;
+    using key_type = K;
+
+private:
+    mutable Vector<K> keys;
+    mutable size_t sorted;
+    Compare comp;
+
+    bool equal(const K& a, const K& b) const {
+        return !comp(a, b) && !comp(b, a);
+    }
+    const K* data() const noexcept {
+        return keys.empty() ? nullptr : &keys[0];
+    }
+
+    void normalize() const {
+        if (sorted == keys.size()) {
+            return;
+        }
+        Vector<size_t> order = merge_order(keys, sorted, comp);
+        Vector<K> keys2;
+        keys2.reserve(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            keys2.push_back(std::move_if_noexcept(keys[order[i]]));
+        }
+        keys = std::move(keys2);
+        sorted = keys.size();
+    }
+
+    size_t lower_index(const K& key) const {
+        normalize();
+        return branchless_lower_bound(data(), keys.size(), key, comp);
+    }
+    size_t index_of(const K& key) const {
+        size_t idx = lower_index(key);
+        return idx < keys.size() && equal(keys[idx], key) ? idx : keys.size();
+    }
+
+public:
+    explicit FlatSet(const Compare& comp = Compare()) : sorted(0), comp(comp) {}
+
+    iterator begin() const {
+        normalize();
+        return data();
+    }
+    iterator end() const {
+        normalize();
+        return data() + keys.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return keys.empty();
+    }
+    size_t size() const {
+        normalize();
+        return keys.size();
+    }
+    void reserve(size_t new_cap) {
+        keys.reserve(new_cap);
+    }
+
+    iterator find(const K& key) const {
+        return data() + index_of(key);
+    }
+    iterator lower_bound(const K& key) const {
+        return data() + lower_index(key);
+    }
+    iterator upper_bound(const K& key) const {
+        size_t idx = lower_index(key);
+        return data() + (idx < keys.size() && equal(keys[idx], key) ? idx + 1 : idx);
+    }
+    bool contains(const K& key) const {
+        return index_of(key) != keys.size();
+    }
+    size_t count(const K& key) const {
+        return contains(key);
+    }
+
+    std::pair<iterator, bool> insert(const K& key) {
+        size_t idx = lower_index(key);
+        if (idx < keys.size() && equal(keys[idx], key)) {
+            return {data() + idx, false};
+        }
+        keys.insert(keys.begin() + idx, key);
+        sorted++;
+        return {data() + idx, true};
+    }
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            keys.push_back(*first);
+        }
+        normalize();
+    }
+    void insert_unsorted(const K& key) {
+        keys.push_back(key);
+    }
+
+    size_t erase(const K& key) {
+        size_t idx = index_of(key);
+        if (idx == keys.size()) {
+            return 0;
+        }
+        keys.erase(keys.begin() + idx);
+        sorted--;
+        return 1;
+    }
+
+    void clear() noexcept {
+        keys.clear();
+        sorted = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef MAPPED_VECTOR_H
+#define MAPPED_VECTOR_H
+
+#include <cerrno> // errno
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstring> // std::memcmp, std::memcpy, std::memmove
+#include <stdexcept> // std::out_of_range, std::runtime_error
+#include <string> // std::string
+#include <system_error> // std::system_error
+#include <type_traits> // std::is_trivially_copyable, std::is_const, std::remove_const, std::conditional
+#include <utility> // std::forward
+
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, mremap, munmap, msync
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close, ftruncate
+
+#include "Vector.h"
+
+/*
+    MappedVector
+    ------------
+
+    A Vector of trivially copyable elements whose storage is a memory-mapped
+    file. Opening one is a single mmap: pages are read lazily as they are
+    touched and the contents persist across restarts. Growth extends the file
+    and remaps it. Several processes can open the same file read-only and
+    share one copy through the page cache.
+
+    The file starts with a small header (magic, element size, element count)
+    followed by the raw elements. The capacity is whatever fits in the file.
+
+    A MappedVector<const T> opens an existing file read-only and maps it
+    without write permission. Its accessors and iterators hand out const
+    references, and the members that would modify it do not compile.
+
+    Example:
+    {
+        MappedVector<double> prices("prices.vec");   // created if missing
+        prices.push_back(42.0);
+    }   // unmapped, the file keeps the data
+    {
+        MappedVector<const double> prices("prices.vec");
+        std::cout << prices[0] << std::endl; // 42
+    }
+*/
+template <class T>
+class MappedVector {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedVector stores raw bytes, so T must be trivially copyable");
+public:
+    using value_type = typename std::remove_const<T>::type;
+    using iterator = typename std::conditional<std::is_const<T>::value, const T*, typename Vector<value_type>::iterator>::type;
+    using const_iterator = const T*;
+
+private:
+    struct Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static constexpr char magic[8] = {'M', 'A', 'P', 'V', 'E', 'C', '0', '1'};
+    // The payload starts on a cache line so T is always suitably aligned
+    static constexpr size_t payload_offset = 64;
+    static_assert(sizeof(Header) <= payload_offset, "Header must fit before the payload");
+    static_assert(alignof(T) <= payload_offset, "T is over-aligned for the payload offset");
+
+    static constexpr bool read_only = std::is_const<T>::value;
+
+    int fd;
+    char* map;
+    size_t map_bytes;
+    size_t _capacity;
+
+    Header* header() const noexcept {
+        return reinterpret_cast<Header*>(map);
+    }
+    T* data() const noexcept {
+        return reinterpret_cast<T*>(map + payload_offset);
+    }
+
+    [[noreturn]] static void fail(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Called first by every member that modifies the vector
+    static void check_writable() noexcept {
+        static_assert(!read_only, "MappedVector<const T> is read-only");
+    }
+
+    // Resizes the file to hold capacity elements and maps the new length
+    void remap(size_t capacity) {
+        size_t bytes = payload_offset + capacity * sizeof(T);
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            fail("ftruncate");
+        }
+#ifdef MREMAP_MAYMOVE
+        void* moved = mremap(map, map_bytes, bytes, MREMAP_MAYMOVE);
+#else
+        munmap(map, map_bytes);
+        void* moved = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#endif
+        if (moved == MAP_FAILED) {
+            fail("mremap");
+        }
+        map = static_cast<char*>(moved);
+        map_bytes = bytes;
+        _capacity = capacity;
+    }
+
+    void unmap() noexcept {
+        if (map != nullptr) {
+            munmap(map, map_bytes);
+            map = nullptr;
+        }
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+public:
+    explicit MappedVector(const std::string& path) : fd(-1), map(nullptr), map_bytes(0), _capacity(0) {
+        fd = open(path.c_str(), read_only ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+        if (fd == -1) {
+            fail("open");
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            unmap();
+            fail("fstat");
+        }
+        size_t bytes = static_cast<size_t>(st.st_size);
+        bool fresh = bytes == 0;
+        if (fresh) {
+            if (read_only) {
+                unmap();
+                throw std::runtime_error("MappedVector: " + path + " is empty");
+            }
+            bytes = payload_offset;
+            if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                unmap();
+                fail("ftruncate");
+            }
+        }
+        if (bytes < payload_offset) {
+            unmap();
+            throw std::runtime_error("MappedVector: " + path + " is too short to have a header");
+        }
+        int prot = read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* ptr = mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            unmap();
+            fail("mmap");
+        }
+        map = static_cast<char*>(ptr);
+        map_bytes = bytes;
+        _capacity = (bytes - payload_offset) / sizeof(T);
+
+        if (fresh) {
+            std::memcpy(header()->magic, magic, sizeof(magic));
+            header()->element_size = sizeof(T);
+            header()->size = 0;
+        }
+        else if (std::memcmp(header()->magic, magic, sizeof(magic)) != 0 || header()->element_size != sizeof(T)
+                 || header()->size > _capacity) {
+            unmap();
+            throw std::runtime_error("MappedVector: " + path + " does not hold this element type");
+        }
+    }
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+    MappedVector(MappedVector&& other) noexcept
+    : fd(other.fd), map(other.map), map_bytes(other.map_bytes), _capacity(other._capacity) {
+        other.fd = -1;
+        other.map = nullptr;
+        other.map_bytes = 0;
+        other._capacity = 0;
+    }
+    MappedVector& operator=(MappedVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        unmap();
+        fd = other.fd;
+        map = other.map;
+        map_bytes = other.map_bytes;
+        _capacity = other._capacity;
+        other.fd = -1;
+        other.map = nullptr;
+        other.map_bytes = 0;
+        other._capacity = 0;
+        return *this;
+    }
+    ~MappedVector() {
+        unmap();
+    }
+
+    iterator begin() {
+        return iterator(data());
+    }
+    iterator end() {
+        return iterator(data() + size());
+    }
+    const_iterator begin() const noexcept {
+        return data();
+    }
+    const_iterator end() const noexcept {
+        return data() + size();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+    size_t size() const noexcept {
+        return map == nullptr ? 0 : static_cast<size_t>(header()->size);
+    }
+    size_t capacity() const noexcept {
+        return _capacity;
+    }
+
+    T& at(size_t pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return data()[pos];
+    }
+    const T& at(size_t pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return data()[pos];
+    }
+    T& operator[](size_t pos) {
+        return data()[pos];
+    }
+    const T& operator[](size_t pos) const {
+        return data()[pos];
+    }
+    T& front() {
+        return data()[0];
+    }
+    const T& front() const {
+        return data()[0];
+    }
+    T& back() {
+        return data()[size() - 1];
+    }
+    const T& back() const {
+        return data()[size() - 1];
+    }
+
+    // Extends the file to hold at least new_cap elements
+    void reserve(size_t new_cap) {
+        check_writable();
+        if (new_cap > _capacity) {
+            remap(new_cap);
+        }
+    }
+    void resize(size_t count, const T& value = T()) {
+        check_writable();
+        reserve(count);
+        for (size_t i = size(); i < count; i++) {
+            data()[i] = value;
+        }
+        header()->size = count;
+    }
+    // Truncates the file to exactly size() elements
+    void shrink_to_fit() {
+        check_writable();
+        if (size() < _capacity) {
+            remap(size());
+        }
+    }
+
+    void push_back(const T& value) {
+        insert(end(), value);
+    }
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        // Built first because args may refer into the mapping
+        T value(std::forward<Args>(args)...);
+        push_back(value);
+        return back();
+    }
+    void pop_back() {
+        check_writable();
+        header()->size--;
+    }
+
+    iterator insert(iterator pos, const T& value) {
+        return insert(pos, 1, value);
+    }
+    iterator insert(iterator pos, size_t count, const T& value) {
+        check_writable();
+        size_t idx = pos - begin();
+        size_t sz = size();
+        // Copied out first because remapping invalidates references into the file
+        T copy = value;
+        if (sz + count > _capacity) {
+            size_t capacity = _capacity == 0 ? 1 : _capacity;
+            while (sz + count > capacity) {
+                capacity *= 2;
+            }
+            remap(capacity);
+        }
+        std::memmove(static_cast<void*>(data() + idx + count), static_cast<const void*>(data() + idx), (sz - idx) * sizeof(T));
+        for (size_t i = idx; i < idx + count; i++) {
+            data()[i] = copy;
+        }
+        header()->size = sz + count;
+        return begin() + idx;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(iterator first, iterator last) {
+        check_writable();
+        size_t idx = first - begin();
+        size_t diff = last - first;
+        std::memmove(static_cast<void*>(data() + idx), static_cast<const void*>(data() + idx + diff), (end() - last) * sizeof(T));
+        header()->size -= diff;
+        return first;
+    }
+
+    // Keeps the file (and its capacity), drops the elements
+    void clear() {
+        check_writable();
+        header()->size = 0;
+    }
+
+    // Flushes dirty pages to the file
+    void sync() {
+        if (map != nullptr && msync(map, map_bytes, MS_SYNC) != 0) {
+            fail("msync");
+        }
+    }
+};
+
+#endif
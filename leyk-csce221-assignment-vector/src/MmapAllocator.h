@@ -0,0 +1,140 @@
+#ifndef MMAP_ALLOCATOR_H
+#define MMAP_ALLOCATOR_H
+
+#include <cstddef> // size_t
+#include <cstring> // std::memcpy
+#include <new> // ::operator new, std::bad_alloc
+#include <type_traits> // std::true_type, std::false_type
+
+#include <sys/mman.h> // mmap, mremap, munmap, madvise
+#include <unistd.h> // sysconf
+
+/*
+    MmapAllocator
+    -------------
+
+    An allocator for huge Vectors of trivially relocatable data. Buffers below
+    the threshold come from the global allocator as usual. Buffers at or above
+    it are anonymous mappings, and growing one goes through reallocate(),
+    which Vector calls instead of allocate-copy-free. On Linux that is a
+    mremap: the kernel moves page table entries instead of copying bytes, so
+    growth neither stalls on a copy nor briefly needs old + new memory.
+    Elsewhere it falls back to map-copy-unmap.
+
+    Example:
+    {
+        // Map anything over 64 MiB and ask for transparent hugepages
+        MmapAllocator<double> alloc(64 << 20, true);
+        Vector<double, MmapAllocator<double>> column(alloc);
+
+        for (size_t i = 0; i < 100000000; i++) {
+            column.push_back(i);
+        }
+    }
+*/
+template <class T>
+class MmapAllocator {
+    template <class U>
+    friend class MmapAllocator;
+
+    size_t threshold;
+    bool hugepages;
+
+    static size_t page_size() noexcept {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+    static size_t round_to_pages(size_t bytes) noexcept {
+        return (bytes + page_size() - 1) & ~(page_size() - 1);
+    }
+    bool is_mapped(size_t count) const noexcept {
+        return count != 0 && count * sizeof(T) >= threshold;
+    }
+
+    void* map(size_t bytes) const {
+        void* ptr = mmap(nullptr, round_to_pages(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        advise(ptr, bytes);
+        return ptr;
+    }
+    void advise(void* ptr, size_t bytes) const noexcept {
+#ifdef MADV_HUGEPAGE
+        if (hugepages) {
+            madvise(ptr, round_to_pages(bytes), MADV_HUGEPAGE);
+        }
+#else
+        (void) ptr;
+        (void) bytes;
+#endif
+    }
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static constexpr size_t default_threshold = 64 * 1024 * 1024;
+
+    explicit MmapAllocator(size_t threshold = default_threshold, bool hugepages = false) noexcept
+    : threshold(threshold), hugepages(hugepages) {}
+    template <class U>
+    MmapAllocator(const MmapAllocator<U>& other) noexcept : threshold(other.threshold), hugepages(other.hugepages) {}
+
+    T* allocate(size_t count) {
+        if (is_mapped(count)) {
+            return static_cast<T*>(map(count * sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (is_mapped(count)) {
+            munmap(ptr, round_to_pages(count * sizeof(T)));
+        }
+        else {
+            ::operator delete(ptr);
+        }
+    }
+
+    // Resizes a buffer holding trivially relocatable elements, keeping the
+    // first min(old_count, new_count) of them. May move the buffer.
+    T* reallocate(T* ptr, size_t old_count, size_t new_count) {
+        if (is_mapped(old_count) && is_mapped(new_count)) {
+            size_t old_bytes = round_to_pages(old_count * sizeof(T));
+            size_t new_bytes = round_to_pages(new_count * sizeof(T));
+            if (old_bytes == new_bytes) {
+                return ptr;
+            }
+#ifdef MREMAP_MAYMOVE
+            void* moved = mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            advise(moved, new_bytes);
+            return static_cast<T*>(moved);
+#endif
+        }
+        // Crossing the threshold (or no mremap): copy into a fresh buffer
+        T* ptr2 = allocate(new_count);
+        size_t kept = old_count < new_count ? old_count : new_count;
+        if (kept != 0) {
+            std::memcpy(static_cast<void*>(ptr2), static_cast<const void*>(ptr), kept * sizeof(T));
+        }
+        deallocate(ptr, old_count);
+        return ptr2;
+    }
+
+    template <class U>
+    bool operator==(const MmapAllocator<U>& other) const noexcept {
+        return threshold == other.threshold;
+    }
+    template <class U>
+    bool operator!=(const MmapAllocator<U>& other) const noexcept {
+        return threshold != other.threshold;
+    }
+};
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <iterator> // std::random_access_iterator_tag
+#include <memory> // std::allocator, std::allocator_traits
+#include <stdexcept> // std::out_of_range
+#include <utility> // std::move, std::forward
+
+#include "Vector.h"
+
+/*
+    SegmentedVector
+    ---------------
+
+    A sequence stored in fixed-size blocks of 2^BlockShift elements, found
+    through a directory (a Vector of block pointers). Growing allocates one
+    more block and never touches the elements already stored, so pointers
+    and references to them stay valid until they are popped or cleared, and
+    growth costs no moves. Only the directory is reallocated, and it holds
+    one pointer per block.
+
+    Element i lives at blocks[i >> BlockShift][i & mask], so random access is
+    still O(1). Elements are only added and removed at the back, which is
+    what keeps them in place.
+
+    Example:
+    {
+        SegmentedVector<Record> records;
+        Record& first = records.emplace_back(...);
+
+        for (size_t i = 0; i < 1000000; i++) {
+            records.push_back(...);
+        }
+        first.touch();   // still the same object
+    }
+*/
+template <class T, size_t BlockShift = 10>
+class SegmentedVector {
+    static_assert(BlockShift < sizeof(size_t) * 8, "Block size does not fit in size_t");
+public:
+    class iterator;
+
+    static constexpr size_t block_size = size_t(1) << BlockShift;
+private:
+    static constexpr size_t mask = block_size - 1;
+
+    using alloc_traits = std::allocator_traits<std::allocator<T>>;
+
+    // Blocks are raw storage: only the first _size slots overall are constructed
+    Vector<T*> blocks;
+    size_t _size;
+    std::allocator<T> alloc;
+
+    T* slot(size_t pos) const noexcept {
+        return blocks[pos >> BlockShift] + (pos & mask);
+    }
+
+    void destroy(size_t from, size_t to) noexcept {
+        for (size_t i = from; i < to; i++) {
+            alloc_traits::destroy(alloc, slot(i));
+        }
+    }
+    // Frees every block past the ones needed for count elements
+    void trim(size_t count) noexcept {
+        size_t keep = (count + mask) >> BlockShift;
+        while (blocks.size() > keep) {
+            alloc_traits::deallocate(alloc, blocks.back(), block_size);
+            blocks.pop_back();
+        }
+    }
+    void release() noexcept {
+        destroy(0, _size);
+        _size = 0;
+        trim(0);
+        blocks.shrink_to_fit();
+    }
+
+public:
+    SegmentedVector() noexcept : _size(0) {}
+    SegmentedVector(size_t count, const T& value) : SegmentedVector() {
+        reserve(count);
+        while (_size < count) {
+            emplace_back(value);
+        }
+    }
+    explicit SegmentedVector(size_t count) : SegmentedVector() {
+        reserve(count);
+        while (_size < count) {
+            emplace_back();
+        }
+    }
+    SegmentedVector(const SegmentedVector& other) : SegmentedVector() {
+        reserve(other._size);
+        for (size_t i = 0; i < other._size; i++) {
+            emplace_back(other[i]);
+        }
+    }
+    SegmentedVector(SegmentedVector&& other) noexcept : blocks(std::move(other.blocks)), _size(other._size) {
+        other._size = 0;
+    }
+
+    ~SegmentedVector() {
+        release();
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        reserve(other._size);
+        for (size_t i = 0; i < other._size; i++) {
+            emplace_back(other[i]);
+        }
+        return *this;
+    }
+    SegmentedVector& operator=(SegmentedVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        blocks = std::move(other.blocks);
+        _size = other._size;
+        other._size = 0;
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, _size);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return _size == 0;
+    }
+    size_t size() const noexcept {
+        return _size;
+    }
+    size_t capacity() const noexcept {
+        return blocks.size() << BlockShift;
+    }
+
+    T& at(size_t pos) {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return *slot(pos);
+    }
+    const T& at(size_t pos) const {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return *slot(pos);
+    }
+    T& operator[](size_t pos) {
+        return *slot(pos);
+    }
+    const T& operator[](size_t pos) const {
+        return *slot(pos);
+    }
+    T& front() {
+        return *slot(0);
+    }
+    const T& front() const {
+        return *slot(0);
+    }
+    T& back() {
+        return *slot(_size - 1);
+    }
+    const T& back() const {
+        return *slot(_size - 1);
+    }
+
+    // Allocates blocks up front for at least new_cap elements
+    void reserve(size_t new_cap) {
+        size_t needed = (new_cap + mask) >> BlockShift;
+        if (needed <= blocks.size()) {
+            return;
+        }
+        blocks.reserve(needed);
+        while (blocks.size() < needed) {
+            blocks.push_back(alloc_traits::allocate(alloc, block_size));
+        }
+    }
+    // Frees the blocks past the last element
+    void shrink_to_fit() {
+        trim(_size);
+        blocks.shrink_to_fit();
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size == capacity()) {
+            // Nothing moves, so args may safely refer into this container
+            blocks.push_back(alloc_traits::allocate(alloc, block_size));
+        }
+        T* ptr = slot(_size);
+        alloc_traits::construct(alloc, ptr, std::forward<Args>(args)...);
+        _size++;
+        return *ptr;
+    }
+    // Keeps the block so alternating push/pop at a block edge does not thrash
+    void pop_back() {
+        _size--;
+        destroy(_size, _size + 1);
+    }
+
+    // Destroys the elements but keeps the blocks for reuse
+    void clear() noexcept {
+        destroy(0, _size);
+        _size = 0;
+    }
+
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+    private:
+        SegmentedVector* _owner;
+        size_t _pos;
+    public:
+        iterator() noexcept : _owner(nullptr), _pos(0) {}
+        iterator(SegmentedVector* owner, size_t pos) noexcept : _owner(owner), _pos(pos) {}
+
+        reference operator*() const noexcept {
+            return (*_owner)[_pos];
+        }
+        pointer operator->() const noexcept {
+            return &(*_owner)[_pos];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*_owner)[_pos + offset];
+        }
+
+        iterator& operator++() noexcept {
+            _pos++;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator copy = *this;
+            _pos++;
+            return copy;
+        }
+        iterator& operator--() noexcept {
+            _pos--;
+            return *this;
+        }
+        iterator operator--(int) noexcept {
+            iterator copy = *this;
+            _pos--;
+            return copy;
+        }
+        iterator& operator+=(difference_type offset) noexcept {
+            _pos += offset;
+            return *this;
+        }
+        iterator operator+(difference_type offset) const noexcept {
+            return iterator(_owner, _pos + offset);
+        }
+        iterator& operator-=(difference_type offset) noexcept {
+            _pos -= offset;
+            return *this;
+        }
+        iterator operator-(difference_type offset) const noexcept {
+            return iterator(_owner, _pos - offset);
+        }
+        difference_type operator-(const iterator& rhs) const noexcept {
+            return static_cast<difference_type>(_pos) - static_cast<difference_type>(rhs._pos);
+        }
+
+        bool operator==(const iterator& rhs) const noexcept {
+            return _pos == rhs._pos;
+        }
+        bool operator!=(const iterator& rhs) const noexcept {
+            return _pos != rhs._pos;
+        }
+        bool operator<(const iterator& rhs) const noexcept {
+            return _pos < rhs._pos;
+        }
+        bool operator>(const iterator& rhs) const noexcept {
+            return _pos > rhs._pos;
+        }
+        bool operator<=(const iterator& rhs) const noexcept {
+            return _pos <= rhs._pos;
+        }
+        bool operator>=(const iterator& rhs) const noexcept {
+            return _pos >= rhs._pos;
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef SHARED_VECTOR_H
+#define SHARED_VECTOR_H
+
+#include <atomic> // std::atomic
+#include <cstddef> // size_t
+#include <stdexcept> // std::out_of_range
+#include <utility> // std::move, std::forward
+
+#include "Vector.h"
+
+/*
+    SharedVector
+    ------------
+
+    A copy-on-write Vector. Copies share one reference counted buffer, so
+    handing a snapshot to another thread is O(1) no matter how large it is.
+    The first write through a copy whose buffer is shared detaches it: that
+    copy gets a private deep copy and everyone else keeps seeing the old
+    contents, so a copy behaves as if it had been deep-copied.
+
+    The const members never detach. The non-const ones (including begin(),
+    end() and the non-const operator[]) detach first, since they hand out
+    mutable access. Read-only code should go through a const reference or
+    cbegin()/cend().
+
+    A reference or iterator handed out that way could still be written
+    through after a later copy, so from then on the buffer is pinned: every
+    later copy of it is a deep copy, until clear() drops the elements the
+    references pointed at. Even a range-for over a non-const SharedVector
+    pins it, so iterate through a const reference when copies should stay
+    O(1).
+
+    Like std::shared_ptr, different SharedVectors sharing a buffer may be
+    used from different threads at once. One SharedVector must not be
+    written by one thread while another uses it.
+
+    Example:
+    {
+        SharedVector<double> live = ...;
+
+        SharedVector<double> snapshot = live;   // no elements copied
+        std::thread reader([snapshot] {         // nor here
+            for (double price : snapshot) { ... } // const, so still shared
+        });
+
+        live.push_back(1.0);                    // live detaches, snapshot is unchanged
+    }
+*/
+template <class T>
+class SharedVector {
+public:
+    using iterator = typename Vector<T>::iterator;
+    using const_iterator = const T*;
+private:
+    struct Shared {
+        std::atomic<size_t> refs;
+        // Set once a mutable reference or iterator into data has escaped
+        bool unshareable;
+        Vector<T> data;
+
+        explicit Shared(Vector<T>&& data) : refs(1), unshareable(false), data(std::move(data)) {}
+        Shared(const Vector<T>& data) : refs(1), unshareable(false), data(data) {}
+    };
+
+    // nullptr while empty and never written, so an empty SharedVector does
+    // not allocate
+    Shared* shared;
+
+    void release() noexcept {
+        if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared;
+        }
+        shared = nullptr;
+    }
+    // Makes sure this is the only owner of the buffer before it is written
+    Vector<T>& detach() {
+        if (shared == nullptr) {
+            shared = new Shared(Vector<T>());
+        }
+        else if (shared->refs.load(std::memory_order_acquire) != 1) {
+            Shared* copy = new Shared(shared->data);
+            release();
+            shared = copy;
+        }
+        return shared->data;
+    }
+    // Detaches for a caller that keeps a mutable reference or iterator
+    Vector<T>& leak() {
+        Vector<T>& data = detach();
+        shared->unshareable = true;
+        return data;
+    }
+    // Shares other's buffer, or copies it if it is unshareable
+    static Shared* share(Shared* other) {
+        if (other == nullptr) {
+            return nullptr;
+        }
+        if (other->unshareable) {
+            return new Shared(other->data);
+        }
+        other->refs.fetch_add(1, std::memory_order_relaxed);
+        return other;
+    }
+    const T* data() const noexcept {
+        return empty() ? nullptr : &shared->data[0];
+    }
+
+public:
+    SharedVector() noexcept : shared(nullptr) {}
+    SharedVector(size_t count, const T& value) : shared(new Shared(Vector<T>(count, value))) {}
+    explicit SharedVector(size_t count) : shared(new Shared(Vector<T>(count))) {}
+    // Takes over a Vector's buffer without copying it
+    SharedVector(Vector<T>&& data) : shared(new Shared(std::move(data))) {}
+    SharedVector(const SharedVector& other) : shared(share(other.shared)) {}
+    SharedVector(SharedVector&& other) noexcept : shared(other.shared) {
+        other.shared = nullptr;
+    }
+
+    ~SharedVector() {
+        release();
+    }
+
+    SharedVector& operator=(const SharedVector& other) {
+        if (this == &other || (shared == other.shared && (shared == nullptr || !shared->unshareable))) {
+            return *this;
+        }
+        Shared* copy = share(other.shared);
+        release();
+        shared = copy;
+        return *this;
+    }
+    SharedVector& operator=(SharedVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        shared = other.shared;
+        other.shared = nullptr;
+        return *this;
+    }
+
+    // How many SharedVectors share this buffer, 0 when there is none
+    size_t use_count() const noexcept {
+        return shared == nullptr ? 0 : shared->refs.load(std::memory_order_acquire);
+    }
+
+    iterator begin() {
+        return leak().begin();
+    }
+    iterator end() {
+        return leak().end();
+    }
+    const_iterator begin() const noexcept {
+        return data();
+    }
+    const_iterator end() const noexcept {
+        return data() + size();
+    }
+    const_iterator cbegin() const noexcept {
+        return data();
+    }
+    const_iterator cend() const noexcept {
+        return data() + size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+    size_t size() const noexcept {
+        return shared == nullptr ? 0 : shared->data.size();
+    }
+    size_t capacity() const noexcept {
+        return shared == nullptr ? 0 : shared->data.capacity();
+    }
+
+    T& at(size_t pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return leak()[pos];
+    }
+    const T& at(size_t pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return shared->data[pos];
+    }
+    T& operator[](size_t pos) {
+        return leak()[pos];
+    }
+    const T& operator[](size_t pos) const {
+        return shared->data[pos];
+    }
+    T& front() {
+        return leak().front();
+    }
+    const T& front() const {
+        return shared->data.front();
+    }
+    T& back() {
+        return leak().back();
+    }
+    const T& back() const {
+        return shared->data.back();
+    }
+
+    void reserve(size_t new_cap) {
+        detach().reserve(new_cap);
+    }
+    void push_back(const T& value) {
+        detach().push_back(value);
+    }
+    void push_back(T&& value) {
+        detach().push_back(std::move(value));
+    }
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        return leak().emplace_back(std::forward<Args>(args)...);
+    }
+    void pop_back() {
+        detach().pop_back();
+    }
+
+    // pos must come from begin() or end() on this SharedVector
+    iterator insert(iterator pos, const T& value) {
+        return leak().insert(pos, value);
+    }
+    iterator insert(iterator pos, T&& value) {
+        return leak().insert(pos, std::move(value));
+    }
+    iterator erase(iterator pos) {
+        return leak().erase(pos);
+    }
+    iterator erase(iterator first, iterator last) {
+        return leak().erase(first, last);
+    }
+
+    // A shared buffer is simply let go rather than copied and then cleared
+    void clear() noexcept {
+        if (shared != nullptr && shared->refs.load(std::memory_order_acquire) == 1) {
+            shared->data.clear();
+            shared->unshareable = false;
+        }
+        else {
+            release();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,331 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm> // std::min
+#include <cstddef> // size_t
+#include <functional> // std::less
+#include <memory> // std::allocator, std::allocator_traits, std::addressof
+#include <new> // placement new
+#include <stdexcept> // std::out_of_range
+#include <utility> // std::move, std::forward
+
+#include "Vector.h"
+#include "relocate.h"
+
+// A Vector which keeps its first N elements inline in the object and only
+// spills to the heap once it outgrows them. Short sequences never allocate.
+// It shares Vector's iterator type, so anything written against
+// Vector<T>::iterator works on both.
+template <class T, size_t N = 8>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs room for at least one inline element");
+public:
+    using iterator = typename Vector<T>::iterator;
+private:
+    using alloc_traits = std::allocator_traits<std::allocator<T>>;
+
+    T* array;
+    size_t _capacity, _size;
+    std::allocator<T> alloc;
+    alignas(T) unsigned char buffer[N * sizeof(T)];
+
+    T* inline_storage() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+    bool is_inline() const noexcept {
+        return array == reinterpret_cast<const T*>(buffer);
+    }
+
+    static void destroy(T* first, T* last) noexcept {
+        for (; first != last; ++first) {
+            first->~T();
+        }
+    }
+    // Destroys every element and drops back to the inline buffer
+    void release() noexcept {
+        destroy(array, array + _size);
+        if (!is_inline()) {
+            alloc_traits::deallocate(alloc, array, _capacity);
+        }
+        array = inline_storage();
+        _capacity = N;
+        _size = 0;
+    }
+    // Takes other's elements, stealing its buffer when it is on the heap.
+    // Expects this to be empty and inline.
+    void take(SmallVector& other) {
+        if (other.is_inline()) {
+            for (; _size < other._size; _size++) {
+                new (array + _size) T(std::move(other.array[_size]));
+            }
+            other.release();
+        }
+        else {
+            array = other.array;
+            _capacity = other._capacity;
+            _size = other._size;
+            other.array = other.inline_storage();
+            other._capacity = N;
+            other._size = 0;
+        }
+    }
+
+    // Moves the live elements into a fresh heap buffer of the given capacity
+    void reallocate(size_t capacity) {
+        T* array2 = alloc_traits::allocate(alloc, capacity);
+        if constexpr (is_trivially_relocatable<T>::value) {
+            relocate_bytes(array2, array, _size);
+        }
+        else {
+            for (size_t i = 0; i < _size; i++) {
+                new (array2 + i) T(std::move(array[i]));
+            }
+            destroy(array, array + _size);
+        }
+        if (!is_inline()) {
+            alloc_traits::deallocate(alloc, array, _capacity);
+        }
+        array = array2;
+        _capacity = capacity;
+    }
+
+    void grow() {
+        reallocate(_capacity * 2);
+    }
+
+    // Whether value is one of the elements, which growing or shifting would
+    // move out from under it
+    bool contains(const T& value) const noexcept {
+        const T* ptr = std::addressof(value);
+        return !std::less<const T*>()(ptr, array) && std::less<const T*>()(ptr, array + _size);
+    }
+
+    // Same contract as Vector::shift_right
+    size_t shift_right(size_t idx, size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+        if constexpr (is_trivially_relocatable<T>::value) {
+            relocate_bytes(array + idx + count, array + idx, _size - idx);
+            return 0;
+        }
+        for (size_t i = _size; i > idx; i--) {
+            if (i - 1 + count >= _size) {
+                new (array + i - 1 + count) T(std::move(array[i - 1]));
+            }
+            else {
+                array[i - 1 + count] = std::move(array[i - 1]);
+            }
+        }
+        return std::min(count, _size - idx);
+    }
+
+public:
+    SmallVector() noexcept : array(inline_storage()), _capacity(N), _size(0) {}
+    SmallVector(size_t count, const T& value) : SmallVector() {
+        if (count > N) {
+            reallocate(count);
+        }
+        for (; _size < count; _size++) {
+            new (array + _size) T(value);
+        }
+    }
+    explicit SmallVector(size_t count) : SmallVector() {
+        if (count > N) {
+            reallocate(count);
+        }
+        for (; _size < count; _size++) {
+            new (array + _size) T();
+        }
+    }
+    SmallVector(const SmallVector& other) : SmallVector() {
+        if (other._size > N) {
+            reallocate(other._size);
+        }
+        for (; _size < other._size; _size++) {
+            new (array + _size) T(other.array[_size]);
+        }
+    }
+    SmallVector(SmallVector&& other) : SmallVector() {
+        take(other);
+    }
+
+    ~SmallVector() {
+        release();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        if (other._size > _capacity) {
+            reallocate(other._size);
+        }
+        for (; _size < other._size; _size++) {
+            new (array + _size) T(other.array[_size]);
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        take(other);
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return iterator(array);
+    }
+    iterator end() noexcept {
+        return iterator(array + _size);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return _size == 0;
+    }
+    size_t size() const noexcept {
+        return _size;
+    }
+    size_t capacity() const noexcept {
+        return _capacity;
+    }
+    // Whether the elements still live in the inline buffer
+    bool small() const noexcept {
+        return is_inline();
+    }
+
+    T& at(size_t pos) {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return array[pos];
+    }
+    const T& at(size_t pos) const {
+        if (pos >= _size) {
+            throw std::out_of_range("error");
+        }
+        return array[pos];
+    }
+    T& operator[](size_t pos) {
+        return array[pos];
+    }
+    const T& operator[](size_t pos) const {
+        return array[pos];
+    }
+    T& front() {
+        return array[0];
+    }
+    const T& front() const {
+        return array[0];
+    }
+    T& back() {
+        return array[_size - 1];
+    }
+    const T& back() const {
+        return array[_size - 1];
+    }
+
+    void push_back(const T& value) {
+        insert(end(), value);
+    }
+    void push_back(T&& value) {
+        insert(end(), std::move(value));
+    }
+    void pop_back() {
+        _size--;
+        array[_size].~T();
+    }
+
+    iterator insert(iterator pos, const T& value) {
+        if (contains(value)) {
+            T copy(value);
+            return insert(pos, std::move(copy));
+        }
+        size_t idx = pos - begin();
+        if (_size >= _capacity) {
+            grow();
+        }
+        if (shift_right(idx, 1) == 0) {
+            new (array + idx) T(value);
+        }
+        else {
+            array[idx] = value;
+        }
+        _size++;
+        return begin() + idx;
+    }
+    iterator insert(iterator pos, T&& value) {
+        if (contains(value)) {
+            T moved(std::move(value));
+            return insert(pos, std::move(moved));
+        }
+        size_t idx = pos - begin();
+        if (_size >= _capacity) {
+            grow();
+        }
+        if (shift_right(idx, 1) == 0) {
+            new (array + idx) T(std::move(value));
+        }
+        else {
+            array[idx] = std::move(value);
+        }
+        _size++;
+        return begin() + idx;
+    }
+    iterator insert(iterator pos, size_t count, const T& value) {
+        if (contains(value)) {
+            T copy(value);
+            return insert(pos, count, copy);
+        }
+        size_t idx = pos - begin();
+        if (_size + count > _capacity) {
+            size_t capacity = _capacity;
+            while (_size + count > capacity) {
+                capacity *= 2;
+            }
+            reallocate(capacity);
+        }
+        size_t assigned = shift_right(idx, count);
+        for (size_t i = idx; i < idx + assigned; i++) {
+            array[i] = value;
+        }
+        for (size_t i = idx + assigned; i < idx + count; i++) {
+            new (array + i) T(value);
+        }
+        _size = _size + count;
+        return begin() + idx;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(iterator first, iterator last) {
+        auto diff = last - first;
+        if (diff == 0) {
+            return first;
+        }
+        if constexpr (is_trivially_relocatable<T>::value) {
+            T* hole = array + (first - begin());
+            destroy(hole, hole + diff);
+            relocate_bytes(hole, hole + diff, end() - last);
+        }
+        else {
+            for (auto i = last; i < end(); i++) {
+                *(i - diff) = std::move(*i);
+            }
+            destroy(array + _size - diff, array + _size);
+        }
+        _size = _size - diff;
+        return first;
+    }
+
+    // Destroys the elements but keeps the buffer for reuse
+    void clear() noexcept {
+        destroy(array, array + _size);
+        _size = 0;
+    }
+};
+
+#endif
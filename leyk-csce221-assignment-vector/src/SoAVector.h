@@ -0,0 +1,316 @@
+#ifndef SOA_VECTOR_H
+#define SOA_VECTOR_H
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <iterator> // std::random_access_iterator_tag
+#include <stdexcept> // std::out_of_range
+#include <tuple> // std::tuple, std::get, std::tuple_element_t
+#include <utility> // std::index_sequence, std::forward
+
+#include "Vector.h"
+
+/*
+    SoAVector
+    ---------
+
+    A sequence of records stored as a structure of arrays: every field lives
+    in its own contiguous Vector column, all of the same length. A scan over
+    one field only pulls that field's bytes through the cache instead of
+    whole records, and the column is a plain array the SIMD kernels in simd.h
+    can run over directly.
+
+    Indexing and the iterator yield tuples of references, one per field.
+
+    Example:
+    {
+        // id, price, quantity
+        SoAVector<int, double, int> orders;
+        orders.push_back(1, 9.99, 3);
+        orders.push_back(2, 4.50, 10);
+
+        std::get<1>(orders[0]) *= 2;            // 19.98
+
+        Column<double> prices = orders.column<1>();
+        double total = simd::accumulate(prices.begin(), prices.end(), 0.0);
+
+        for (auto [id, price, quantity] : orders) {
+            quantity++;
+        }
+    }
+*/
+
+// A view of one contiguous column, valid until the owner next grows
+template <class T>
+class Column {
+    T* _data;
+    size_t _size;
+
+public:
+    Column(T* data, size_t size) noexcept : _data(data), _size(size) {}
+
+    T* data() const noexcept {
+        return _data;
+    }
+    size_t size() const noexcept {
+        return _size;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return _size == 0;
+    }
+    T* begin() const noexcept {
+        return _data;
+    }
+    T* end() const noexcept {
+        return _data + _size;
+    }
+    T& operator[](size_t pos) const {
+        return _data[pos];
+    }
+};
+
+template <class... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+public:
+    class iterator;
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+private:
+    using indices = std::index_sequence_for<Fields...>;
+
+    std::tuple<Vector<Fields>...> columns;
+
+    template <class F>
+    void each_column(F f) {
+        std::apply([&](auto&... column) { (f(column), ...); }, columns);
+    }
+
+    template <size_t... Is>
+    reference row(size_t pos, std::index_sequence<Is...>) {
+        return reference(std::get<Is>(columns)[pos]...);
+    }
+    template <size_t... Is>
+    const_reference row(size_t pos, std::index_sequence<Is...>) const {
+        return const_reference(std::get<Is>(columns)[pos]...);
+    }
+
+    // Removes the value just inserted at pos from the first done columns
+    template <size_t... Is>
+    void undo(size_t pos, size_t done, std::index_sequence<Is...>) noexcept {
+        ((Is < done ? (void) std::get<Is>(columns).erase(std::get<Is>(columns).begin() + pos) : (void) 0), ...);
+    }
+
+    // Inserts one value per column at pos. If a column throws, the columns
+    // already done are rolled back so they all keep the same length.
+    template <size_t... Is, class... Args>
+    void insert_row(size_t pos, std::index_sequence<Is...> seq, Args&&... values) {
+        size_t done = 0;
+        try {
+            ((std::get<Is>(columns).insert(std::get<Is>(columns).begin() + pos, std::forward<Args>(values)), done++), ...);
+        }
+        catch (...) {
+            undo(pos, done, seq);
+            throw;
+        }
+    }
+
+public:
+    SoAVector() = default;
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+    size_t size() const noexcept {
+        return std::get<0>(columns).size();
+    }
+    size_t capacity() const noexcept {
+        return std::get<0>(columns).capacity();
+    }
+
+    // Contiguous access to a single field
+    template <size_t I>
+    Column<field_type<I>> column() noexcept {
+        Vector<field_type<I>>& col = std::get<I>(columns);
+        return Column<field_type<I>>(col.empty() ? nullptr : &col[0], col.size());
+    }
+    template <size_t I>
+    Column<const field_type<I>> column() const noexcept {
+        const Vector<field_type<I>>& col = std::get<I>(columns);
+        return Column<const field_type<I>>(col.empty() ? nullptr : &col[0], col.size());
+    }
+
+    template <size_t I>
+    field_type<I>& get(size_t pos) {
+        return std::get<I>(columns)[pos];
+    }
+    template <size_t I>
+    const field_type<I>& get(size_t pos) const {
+        return std::get<I>(columns)[pos];
+    }
+
+    reference at(size_t pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return row(pos, indices());
+    }
+    const_reference at(size_t pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("error");
+        }
+        return row(pos, indices());
+    }
+    reference operator[](size_t pos) {
+        return row(pos, indices());
+    }
+    const_reference operator[](size_t pos) const {
+        return row(pos, indices());
+    }
+    reference front() {
+        return row(0, indices());
+    }
+    const_reference front() const {
+        return row(0, indices());
+    }
+    reference back() {
+        return row(size() - 1, indices());
+    }
+    const_reference back() const {
+        return row(size() - 1, indices());
+    }
+
+    void reserve(size_t new_cap) {
+        each_column([&](auto& column) { column.reserve(new_cap); });
+    }
+    void shrink_to_fit() {
+        each_column([](auto& column) { column.shrink_to_fit(); });
+    }
+
+    void push_back(const Fields&... values) {
+        insert_row(size(), indices(), values...);
+    }
+    void push_back(Fields&&... values) {
+        insert_row(size(), indices(), std::move(values)...);
+    }
+    void pop_back() {
+        each_column([](auto& column) { column.pop_back(); });
+    }
+
+    iterator insert(iterator pos, const Fields&... values) {
+        insert_row(pos - begin(), indices(), values...);
+        return pos;
+    }
+    iterator insert(iterator pos, Fields&&... values) {
+        insert_row(pos - begin(), indices(), std::move(values)...);
+        return pos;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(iterator first, iterator last) {
+        size_t from = first - begin(), to = last - begin();
+        each_column([&](auto& column) { column.erase(column.begin() + from, column.begin() + to); });
+        return first;
+    }
+
+    // Destroys the records but keeps every column's buffer
+    void clear() noexcept {
+        each_column([](auto& column) { column.clear(); });
+    }
+
+    // A proxy iterator: dereferencing gives a tuple of references into the
+    // columns, so it cannot hand out a pointer to a whole record
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SoAVector::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = SoAVector::reference;
+    private:
+        SoAVector* _owner;
+        size_t _pos;
+    public:
+        iterator() noexcept : _owner(nullptr), _pos(0) {}
+        iterator(SoAVector* owner, size_t pos) noexcept : _owner(owner), _pos(pos) {}
+
+        reference operator*() const {
+            return (*_owner)[_pos];
+        }
+        reference operator[](difference_type offset) const {
+            return (*_owner)[_pos + offset];
+        }
+        size_t index() const noexcept {
+            return _pos;
+        }
+
+        iterator& operator++() noexcept {
+            _pos++;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator copy = *this;
+            _pos++;
+            return copy;
+        }
+        iterator& operator--() noexcept {
+            _pos--;
+            return *this;
+        }
+        iterator operator--(int) noexcept {
+            iterator copy = *this;
+            _pos--;
+            return copy;
+        }
+        iterator& operator+=(difference_type offset) noexcept {
+            _pos += offset;
+            return *this;
+        }
+        iterator operator+(difference_type offset) const noexcept {
+            return iterator(_owner, _pos + offset);
+        }
+        iterator& operator-=(difference_type offset) noexcept {
+            _pos -= offset;
+            return *this;
+        }
+        iterator operator-(difference_type offset) const noexcept {
+            return iterator(_owner, _pos - offset);
+        }
+        difference_type operator-(const iterator& rhs) const noexcept {
+            return static_cast<difference_type>(_pos) - static_cast<difference_type>(rhs._pos);
+        }
+
+        bool operator==(const iterator& rhs) const noexcept {
+            return _pos == rhs._pos;
+        }
+        bool operator!=(const iterator& rhs) const noexcept {
+            return _pos != rhs._pos;
+        }
+        bool operator<(const iterator& rhs) const noexcept {
+            return _pos < rhs._pos;
+        }
+        bool operator>(const iterator& rhs) const noexcept {
+            return _pos > rhs._pos;
+        }
+        bool operator<=(const iterator& rhs) const noexcept {
+            return _pos <= rhs._pos;
+        }
+        bool operator>=(const iterator& rhs) const noexcept {
+            return _pos >= rhs._pos;
+        }
+    };
+};
+
+#endif
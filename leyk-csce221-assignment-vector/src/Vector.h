@@ -1,91 +1,284 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
-#include <algorithm> // std::random_access_iterator_tag
+#include <algorithm> // std::max, std::min, std::rotate
 #include <cstddef> // size_t
+#include <iterator> // std::iterator_traits, std::distance, std::begin, std::end
+#include <memory> // std::allocator, std::allocator_traits
 #include <stdexcept> // std::out_of_range
-#include <type_traits> // std::is_same
+#include <type_traits> // std::is_same, std::is_integral, std::enable_if_t, std::void_t
+#include <utility> // std::move, std::forward
 
-template <class T>
+#include "relocate.h"
+
+// Allocators may provide T* reallocate(T* ptr, size_t old_count, size_t new_count)
+// to resize a buffer of trivially relocatable elements in place (see MmapAllocator)
+namespace {
+    template <class _Alloc, class = void>
+    struct has_reallocate : std::false_type {};
+
+    template <class _Alloc>
+    struct has_reallocate<_Alloc, std::void_t<decltype(std::declval<_Alloc&>().reallocate(
+        std::declval<typename _Alloc::value_type*>(), size_t(), size_t()))>> : std::true_type {};
+}
+
+template <class T, class Alloc = std::allocator<T>>
 class Vector {
 public:
     class iterator;
+    using allocator_type = Alloc;
 private:
+    using alloc_traits = std::allocator_traits<Alloc>;
+
     T* array;
     size_t _capacity, _size;
+    Alloc alloc;
 
-    // You may want to write a function that grows the vector
-    void grow() {
-        if (array == nullptr) {
-            _capacity = 1;
-            T* array2 = new T[_capacity];
-            delete[] array; 
-            array = array2;
+    // Storage is raw memory: only the live elements in [0, _size) are ever
+    // constructed, the spare slots in [_size, _capacity) are uninitialized
+    T* allocate(size_t count) {
+        return alloc_traits::allocate(alloc, count);
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        if (ptr != nullptr) {
+            alloc_traits::deallocate(alloc, ptr, count);
+        }
+    }
+    template <class... Args>
+    void construct(T* ptr, Args&&... args) {
+        alloc_traits::construct(alloc, ptr, std::forward<Args>(args)...);
+    }
+    void destroy(T* first, T* last) noexcept {
+        for (; first != last; ++first) {
+            alloc_traits::destroy(alloc, first);
+        }
+    }
+    // Destroys every element and hands the buffer back to the allocator
+    void release() noexcept {
+        destroy(array, array + _size);
+        deallocate(array, _capacity);
+        array = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+    void steal(Vector& other) noexcept {
+        array = other.array;
+        _size = other._size;
+        _capacity = other._capacity;
+        other.array = nullptr;
+        other._size = 0;
+        other._capacity = 0;
+    }
+
+    // Moves the live elements into array2, a fresh buffer of the given
+    // capacity, and frees the old one
+    void adopt(T* array2, size_t capacity) {
+        if constexpr (is_trivially_relocatable<T>::value) {
+            relocate_bytes(array2, array, _size);
         }
         else {
-            _capacity = _capacity * 2;
-            T* array2 = new T[_capacity];
             for (size_t i = 0; i < _size; i++) {
-                array2[i] = std::move(array[i]);
+                construct(array2 + i, std::move(array[i]));
+            }
+            destroy(array, array + _size);
+        }
+        deallocate(array, _capacity);
+        array = array2;
+        _capacity = capacity;
+    }
+    void reallocate(size_t capacity) {
+        if constexpr (is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value) {
+            if (array != nullptr) {
+                array = alloc.reallocate(array, _capacity, capacity);
+                _capacity = capacity;
+                return;
+            }
+        }
+        adopt(allocate(capacity), capacity);
+    }
+
+    // You may want to write a function that grows the vector
+    void grow() {
+        reallocate(_capacity == 0 ? 1 : _capacity * 2);
+    }
+
+    // Opens a gap of count slots at index idx by shifting the tail right.
+    // Slots past the old end are constructed, the rest are moved over.
+    // Returns the number of gap slots which are still constructed and so
+    // must be assigned (rather than constructed) by the caller.
+    size_t shift_right(size_t idx, size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+        if constexpr (is_trivially_relocatable<T>::value) {
+            // The whole gap is left as raw memory
+            relocate_bytes(array + idx + count, array + idx, _size - idx);
+            return 0;
+        }
+        for (size_t i = _size; i > idx; i--) {
+            if (i - 1 + count >= _size) {
+                construct(array + i - 1 + count, std::move(array[i - 1]));
             }
-            delete[] array; 
+            else {
+                array[i - 1 + count] = std::move(array[i - 1]);
+            }
+        }
+        return std::min(count, _size - idx);
+    }
+
+    // Inserts count elements at idx with at most one reallocation and one
+    // pass over the tail. put(slot, assign) builds the next new element in
+    // slot, assigning over it when assign is true and constructing it
+    // otherwise; it is called count times, in order.
+    template <class Put>
+    void open_gap(size_t idx, size_t count, Put put) {
+        if (count == 0) {
+            return;
+        }
+        size_t needed = _size + count;
+        if (needed > _capacity && !(is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value && array != nullptr)) {
+            // Build the new elements straight into a fresh buffer, then move
+            // the old ones around them: the tail moves once, and put may
+            // still read from the old buffer
+            size_t capacity = std::max(needed, _capacity * 2);
+            T* array2 = allocate(capacity);
+            size_t built = 0;
+            try {
+                for (; built < count; built++) {
+                    put(array2 + idx + built, false);
+                }
+            }
+            catch (...) {
+                destroy(array2 + idx, array2 + idx + built);
+                deallocate(array2, capacity);
+                throw;
+            }
+            if constexpr (is_trivially_relocatable<T>::value) {
+                relocate_bytes(array2, array, idx);
+                relocate_bytes(array2 + idx + count, array + idx, _size - idx);
+            }
+            else {
+                for (size_t i = 0; i < _size; i++) {
+                    construct(array2 + (i < idx ? i : i + count), std::move(array[i]));
+                }
+                destroy(array, array + _size);
+            }
+            deallocate(array, _capacity);
             array = array2;
+            _capacity = capacity;
+            _size = needed;
+            return;
+        }
+        if (needed > _capacity) {
+            // The allocator can resize the buffer in place
+            reallocate(std::max(needed, _capacity * 2));
         }
+        size_t assigned = shift_right(idx, count);
+        for (size_t i = idx; i < idx + count; i++) {
+            put(array + i, i < idx + assigned);
+        }
+        _size = needed;
+    }
+
+    // Slides every element for which keep(idx, element) is true down over
+    // the ones for which it is false, in one pass and at most one move per
+    // survivor. keep is called once per element, in order. Returns the
+    // number of elements removed.
+    template <class Keep>
+    size_t compact(Keep keep) {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; i++) {
+            if (keep(i, array[i])) {
+                if (kept != i) {
+                    array[kept] = std::move(array[i]);
+                }
+                kept++;
+            }
+        }
+        size_t removed = _size - kept;
+        destroy(array + kept, array + _size);
+        _size = kept;
+        return removed;
     }
-    
 
 public:
-    Vector() noexcept : array(nullptr), _capacity(0), _size(0) { /* TODO */ }
-    Vector(size_t count, const T& value) : _capacity(count), _size(count), array(new T[count]) {
-        for (auto i = 0; i < count; i++) {
-            array[i] = value;
+    Vector() noexcept : array(nullptr), _capacity(0), _size(0), alloc() { /* TODO */ }
+    explicit Vector(const Alloc& alloc) noexcept : array(nullptr), _capacity(0), _size(0), alloc(alloc) {}
+    Vector(size_t count, const T& value, const Alloc& alloc = Alloc()) : array(nullptr), _capacity(count), _size(0), alloc(alloc) {
+        array = allocate(count);
+        for (; _size < count; _size++) {
+            construct(array + _size, value);
         }
     }
-    explicit Vector(size_t count) : _size(count), _capacity(count), array(new T[count]()) { 
+    explicit Vector(size_t count, const Alloc& alloc = Alloc()) : array(nullptr), _capacity(count), _size(0), alloc(alloc) {
+        array = allocate(count);
+        for (; _size < count; _size++) {
+            construct(array + _size);
+        }
     }
-    Vector(const Vector& other) : array(new T[other._capacity]), _capacity(other._capacity), _size(other._size) {
-        for (size_t i = 0; i < _size; i++) {
-            array[i] = other.array[i];
+    Vector(const Vector& other)
+    : array(nullptr), _capacity(other._capacity), _size(0), alloc(alloc_traits::select_on_container_copy_construction(other.alloc)) {
+        array = allocate(_capacity);
+        for (; _size < other._size; _size++) {
+            construct(array + _size, other.array[_size]);
         }
     }
-    Vector(Vector&& other) noexcept : array(other.array), _capacity(other._capacity), _size(other._size) { 
+    Vector(Vector&& other) noexcept : array(other.array), _capacity(other._capacity), _size(other._size), alloc(std::move(other.alloc)) { 
         other._size = 0;
         other._capacity = 0;
         other.array = nullptr;
      }
 
     ~Vector() {
-        delete[] array;
-        array = nullptr;
+        release();
     }
 
     Vector& operator=(const Vector& other) {
         if (this == &other) {
             return *this;
         }
-        delete[] array;
-        array = new T[other._capacity];
-        _size = other._size;
+        release();
+        if (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc = other.alloc;
+        }
+        // Leave this empty (rather than dangling) if the allocation throws
+        array = allocate(other._capacity);
         _capacity = other._capacity;
-        for (auto i = 0; i < _size; i++) {
-            array[i] = other.array[i];
+        for (; _size < other._size; _size++) {
+            construct(array + _size, other.array[_size]);
         }
         return *this;
      }
-    Vector& operator=(Vector&& other) noexcept {
+    Vector& operator=(Vector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                               || alloc_traits::is_always_equal::value) {
         if (this == &other) {
             return *this;
         }
-        delete[] array;
-        array = std::move(other.array);
-        _size = other._size;
-        _capacity = other._capacity;
-        other.array = nullptr;
-        other._size = 0;
-        other._capacity = 0;
+        release();
+        if (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc = std::move(other.alloc);
+            steal(other);
+        }
+        else if (alloc == other.alloc) {
+            steal(other);
+        }
+        else {
+            // The buffer belongs to an allocator we cannot free from, so the
+            // elements have to be moved into storage of our own
+            array = allocate(other._capacity);
+            _capacity = other._capacity;
+            for (; _size < other._size; _size++) {
+                construct(array + _size, std::move(other.array[_size]));
+            }
+            other.release();
+        }
         return *this;
     }
 
+    allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
     iterator begin() noexcept {
         return iterator(array);       
     }
@@ -106,6 +299,45 @@ public:
         return _capacity;
     }
 
+    // Grows the buffer to hold at least new_cap elements. Never shrinks.
+    void reserve(size_t new_cap) {
+        if (new_cap > _capacity) {
+            reallocate(new_cap);
+        }
+    }
+    // Shrinks the buffer to exactly size() elements
+    void shrink_to_fit() {
+        if (_size == 0) {
+            release();
+        }
+        else if (_size < _capacity) {
+            reallocate(_size);
+        }
+    }
+    // Value-initializes (or copies value into) any new elements
+    void resize(size_t count) {
+        if (count < _size) {
+            destroy(array + count, array + _size);
+            _size = count;
+            return;
+        }
+        reserve(count);
+        for (; _size < count; _size++) {
+            construct(array + _size);
+        }
+    }
+    void resize(size_t count, const T& value) {
+        if (count < _size) {
+            destroy(array + count, array + _size);
+            _size = count;
+            return;
+        }
+        reserve(count);
+        for (; _size < count; _size++) {
+            construct(array + _size, value);
+        }
+    }
+
     T& at(size_t pos) {
         if (pos < 0 || pos >= _size) {
             throw std::out_of_range("error");
@@ -143,8 +375,33 @@ public:
     void push_back(T&& value) {
         insert(end(), std::move(value));
     }
+    // Constructs the element in place from args
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size < _capacity) {
+            construct(array + _size, std::forward<Args>(args)...);
+        }
+        else if constexpr (is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value) {
+            // The buffer is resized in place, so build the element first in
+            // case args refer into this vector
+            T value(std::forward<Args>(args)...);
+            grow();
+            construct(array + _size, std::move(value));
+        }
+        else {
+            // args may refer into this vector, so the new element is built
+            // before the old ones are moved out from under it
+            size_t capacity = _capacity == 0 ? 1 : _capacity * 2;
+            T* array2 = allocate(capacity);
+            construct(array2 + _size, std::forward<Args>(args)...);
+            adopt(array2, capacity);
+        }
+        _size++;
+        return back();
+    }
     void pop_back() {
         _size--;
+        destroy(array + _size, array + _size + 1);
     }
 
     iterator insert(iterator pos, const T& value) {
@@ -153,10 +410,13 @@ public:
             grow();
             pos = diff + begin();
         }
-        for (auto i = end(); i > pos; i--) {
-            *i = std::move(*(i - 1));
+        size_t idx = pos - begin();
+        if (shift_right(idx, 1) == 0) {
+            construct(array + idx, value);
+        }
+        else {
+            *pos = value;
         }
-        *pos = value;
         _size++;
         return pos;
         
@@ -167,45 +427,124 @@ public:
             grow();
             pos = diff + begin();
         }
-        for (auto i = end(); i > pos; i--) {
-            *i = std::move(*(i - 1));
+        size_t idx = pos - begin();
+        if (shift_right(idx, 1) == 0) {
+            construct(array + idx, std::move(value));
+        }
+        else {
+            *pos = std::move(value);
         }
-        *pos = std::move(value);
         _size++;
         return pos;
     }
     iterator insert(iterator pos, size_t count, const T& value) {
-        while (_size + count >= _capacity) {
-            auto diff = pos - begin();
-            grow();
-            pos = diff + begin();
+        size_t idx = pos - begin();
+        if constexpr (is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value) {
+            // The buffer may be resized in place, so value may not survive
+            T copy = value;
+            open_gap(idx, count, [&](T* slot, bool assign) { assign ? void(*slot = copy) : construct(slot, copy); });
         }
-        for (auto i = end() - 1; i >= pos; i--) {
-            *(i + count) = std::move(*i);
+        else {
+            open_gap(idx, count, [&](T* slot, bool assign) { assign ? void(*slot = value) : construct(slot, value); });
         }
-        for (auto i = pos; i != (pos + count); i++) {
-            *i = value;
+        return begin() + idx;
+    }
+    // Inserts a copy of [first, last). Forward ranges are measured first so
+    // the vector grows at most once; [first, last) must not be in this vector.
+    template <class InputIterator, class = std::enable_if_t<!std::is_integral<InputIterator>::value>>
+    iterator insert(iterator pos, InputIterator first, InputIterator last) {
+        size_t idx = pos - begin();
+        using category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            size_t count = std::distance(first, last);
+            open_gap(idx, count, [&](T* slot, bool assign) {
+                if (assign) {
+                    *slot = *first;
+                }
+                else {
+                    construct(slot, *first);
+                }
+                ++first;
+            });
         }
-        _size = _size + count;
-        return pos;
-
+        else {
+            // Single pass: append, then rotate the new elements into place
+            size_t old_size = _size;
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+            std::rotate(array + idx, array + old_size, array + _size);
+        }
+        return begin() + idx;
     }
-    iterator erase(iterator pos) {
-        for (auto i = pos + 1; i < end(); i++) {
-            *(i - 1) = std::move(*i);
+    // Appends every element of range (anything std::begin/std::end accept)
+    template <class Range>
+    void append_range(Range&& range) {
+        insert(end(), std::begin(range), std::end(range));
+    }
+    // Replaces the contents with a copy of [first, last), reusing the buffer
+    // when it is large enough
+    template <class InputIterator, class = std::enable_if_t<!std::is_integral<InputIterator>::value>>
+    void assign(InputIterator first, InputIterator last) {
+        clear();
+        using category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            size_t count = std::distance(first, last);
+            if (count > _capacity) {
+                release();
+                array = allocate(count);
+                _capacity = count;
+            }
         }
-        _size--;
-        return pos;
+        insert(end(), first, last);
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, pos + 1);
     }
     iterator erase(iterator first, iterator last) {
         auto diff = last - first;
-        for (auto i = last; i < end(); i++) {
-            *(i - diff) = std::move(*i);
+        // An empty range would otherwise self-move every element after it
+        if (diff == 0) {
+            return first;
+        }
+        if constexpr (is_trivially_relocatable<T>::value) {
+            T* hole = array + (first - begin());
+            destroy(hole, hole + diff);
+            relocate_bytes(hole, hole + diff, end() - last);
+        }
+        else {
+            for (auto i = last; i < end(); i++) {
+                *(i - diff) = std::move(*i);
+            }
+            destroy(array + _size - diff, array + _size);
         }
         _size = _size - diff;
         return first;
     }
 
+    // Removes every element matching pred, returns how many were removed
+    template <class Predicate>
+    size_t erase_if(Predicate pred) {
+        return compact([&](size_t, T& value) { return !pred(value); });
+    }
+    // Keeps only the elements matching pred, returns how many were removed
+    template <class Predicate>
+    size_t retain(Predicate pred) {
+        return compact([&](size_t, T& value) { return static_cast<bool>(pred(value)); });
+    }
+    // Removes the elements at the given ascending indices. Repeated indices
+    // count once and indices past the end are ignored. Returns how many
+    // were removed.
+    template <class IndexIterator>
+    size_t remove_indices(IndexIterator first, IndexIterator last) {
+        return compact([&](size_t idx, T&) {
+            while (first != last && static_cast<size_t>(*first) < idx) {
+                ++first;
+            }
+            return first == last || static_cast<size_t>(*first) != idx;
+        });
+    }
+
     class iterator {
     public:
         using iterator_category = std::random_access_iterator_tag;
@@ -213,6 +552,8 @@ public:
         using difference_type   = ptrdiff_t;
         using pointer           = T*;
         using reference         = T&;
+        // Marks every Vector<T, Alloc>::iterator for the free operator+ below
+        using vector_iterator_tag = void;
     private:
         // Points to some element in the vector (or nullptr)
         T* _ptr;
@@ -322,22 +663,25 @@ public:
     };
 
 
+    // Destroys the elements but keeps the buffer for reuse
     void clear() noexcept {
-        delete[] array;
-        array = nullptr;
+        destroy(array, array + _size);
         _size = 0;
     }
 };
 
-// This ensures at compile time that the deduced argument _Iterator is a Vector<T>::iterator
-// There is no way we know of to back-substitute template <typename T> for external functions
-// because it leads to a non-deduced context
+// This ensures at compile time that the deduced argument _Iterator is a Vector<T, Alloc>::iterator
+// for any allocator. Back-substituting template <typename T, class Alloc> for external functions
+// leads to a non-deduced context, so the iterator carries a tag instead
 namespace {
+    template <typename _Iterator, typename = void>
+    struct is_vector_iterator : std::false_type {};
+
     template <typename _Iterator>
-    using is_vector_iterator = std::is_same<typename Vector<typename _Iterator::value_type>::iterator, _Iterator>;
+    struct is_vector_iterator<_Iterator, std::void_t<typename _Iterator::vector_iterator_tag>> : std::true_type {};
 }
 
-template <typename _Iterator, bool _enable = is_vector_iterator<_Iterator>::value>
+template <typename _Iterator, typename = std::enable_if_t<is_vector_iterator<_Iterator>::value>>
 [[nodiscard]] _Iterator operator+(typename _Iterator::difference_type offset, _Iterator const& iterator) noexcept {
     return iterator + offset; 
 }
@@ -0,0 +1,314 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm> // std::min, std::max
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef> // size_t, ptrdiff_t
+#include <exception> // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional> // std::function
+#include <iterator> // std::iterator_traits
+#include <mutex> // std::mutex, std::unique_lock
+#include <numeric> // std::lcm
+#include <thread> // std::thread
+#include <utility> // std::move
+#include <vector> // std::vector
+
+#include "Vector.h"
+
+/*
+    Parallel algorithms over Vector ranges
+    --------------------------------------
+
+    for_each, transform, reduce and inclusive_scan split [first, last) into
+    chunks and run them on a reusable pool of worker threads (the calling
+    thread works too). Chunks are at least `grain` elements and a multiple
+    of lcm(sizeof(T), 64) / sizeof(T) elements, so every chunk boundary
+    falls on a 64 byte line boundary and neighbouring chunks written by
+    different threads only share a line when the buffer itself is not line
+    aligned.
+
+    The chunking depends only on the length of the range and the grain, never
+    on the number of threads or on scheduling. reduce and inclusive_scan
+    combine the per-chunk results left to right, so for a given input and
+    grain they return bit-identical results on every run and every machine,
+    even for floating point. op must be associative.
+
+    Example:
+    {
+        Vector<double> v = ...;
+
+        parallel::for_each(v.begin(), v.end(), [](double& x) { x *= 2; });
+        double total = parallel::reduce(v.begin(), v.end(), 0.0, std::plus<double>());
+    }
+
+    Calls made from inside a task run serially instead of deadlocking on the
+    pool. If a task throws, the tasks of its batch that have not started yet
+    are skipped and the first exception is rethrown on the calling thread.
+*/
+namespace parallel {
+
+    constexpr size_t cache_line = 64;
+    constexpr size_t default_grain = 16 * 1024;
+
+    // A fixed set of workers which execute one batch of indexed tasks at a time
+    class ThreadPool {
+        std::vector<std::thread> workers;
+        std::mutex batch_lock;
+        std::mutex lock;
+        std::condition_variable wake, finished;
+
+        // The current batch, only changed while no worker is active
+        const std::function<void(size_t)>* task;
+        size_t n_tasks;
+        std::atomic<size_t> next;
+        size_t n_done;
+        size_t n_active;
+        size_t generation;
+        bool stopping;
+        // First exception thrown by a task of the current batch
+        std::exception_ptr error;
+        std::atomic<bool> failed;
+
+        static bool& inside_task() noexcept {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        // Claims and runs tasks until the batch is exhausted. Once a task has
+        // thrown, the rest are claimed but not run.
+        size_t drain(const std::function<void(size_t)>& fn, size_t count) {
+            size_t done = 0;
+            for (size_t i = next++; i < count; i = next++) {
+                if (!failed.load(std::memory_order_relaxed)) {
+                    inside_task() = true;
+                    try {
+                        fn(i);
+                    }
+                    catch (...) {
+                        std::unique_lock<std::mutex> guard(lock);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        failed = true;
+                    }
+                    inside_task() = false;
+                }
+                done++;
+            }
+            return done;
+        }
+
+        void work() {
+            size_t seen = 0;
+            while (true) {
+                const std::function<void(size_t)>* fn;
+                size_t count;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    wake.wait(guard, [&] { return stopping || generation != seen; });
+                    if (stopping) {
+                        return;
+                    }
+                    seen = generation;
+                    // Woken too late: the batch finished and run() may have
+                    // returned, so task no longer points at a live function
+                    if (n_done == n_tasks) {
+                        continue;
+                    }
+                    fn = task;
+                    count = n_tasks;
+                    n_active++;
+                }
+                size_t done = drain(*fn, count);
+                std::unique_lock<std::mutex> guard(lock);
+                n_done += done;
+                n_active--;
+                if (n_done == n_tasks && n_active == 0) {
+                    finished.notify_all();
+                }
+            }
+        }
+
+    public:
+        // threads counts the caller, so a pool of 1 runs everything inline
+        explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
+        : task(nullptr), n_tasks(0), next(0), n_done(0), n_active(0), generation(0), stopping(false), failed(false) {
+            for (size_t i = 1; i < threads; i++) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool() {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        }
+
+        size_t size() const noexcept {
+            return workers.size() + 1;
+        }
+
+        // Runs fn(0) .. fn(count - 1) across the pool and returns when all
+        // of them have finished. Rethrows the first exception a task threw.
+        void run(size_t count, const std::function<void(size_t)>& fn) {
+            if (count == 0) {
+                return;
+            }
+            if (workers.empty() || count == 1 || inside_task()) {
+                for (size_t i = 0; i < count; i++) {
+                    fn(i);
+                }
+                return;
+            }
+            std::unique_lock<std::mutex> batch(batch_lock);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                task = &fn;
+                n_tasks = count;
+                next = 0;
+                n_done = 0;
+                error = nullptr;
+                failed = false;
+                generation++;
+            }
+            wake.notify_all();
+            size_t done = drain(fn, count);
+            std::unique_lock<std::mutex> guard(lock);
+            n_done += done;
+            // Workers still counted as active may hold a pointer to fn
+            finished.wait(guard, [&] { return n_done == n_tasks && n_active == 0; });
+            if (error) {
+                std::exception_ptr thrown = error;
+                error = nullptr;
+                std::rethrow_exception(thrown);
+            }
+        }
+    };
+
+    inline ThreadPool& default_pool() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Splits n elements of the given size into chunks of at least grain
+    // elements, rounded up so each chunk spans a whole number of cache lines
+    class Chunks {
+        size_t n, per_chunk;
+
+    public:
+        Chunks(size_t n, size_t element_size, size_t grain) : n(n) {
+            // The fewest elements that end exactly on a line boundary
+            size_t per_lines = std::lcm(element_size, cache_line) / element_size;
+            per_chunk = std::max<size_t>(grain, 1);
+            per_chunk = (per_chunk + per_lines - 1) / per_lines * per_lines;
+        }
+        size_t count() const noexcept {
+            return (n + per_chunk - 1) / per_chunk;
+        }
+        size_t begin(size_t chunk) const noexcept {
+            return chunk * per_chunk;
+        }
+        size_t end(size_t chunk) const noexcept {
+            return std::min(n, (chunk + 1) * per_chunk);
+        }
+    };
+
+    template <class Iterator, class Function>
+    void for_each(Iterator first, Iterator last, Function f, size_t grain = default_grain, ThreadPool& pool = default_pool()) {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+        Chunks chunks(last - first, sizeof(T), grain);
+        pool.run(chunks.count(), [&](size_t c) {
+            for (Iterator it = first + chunks.begin(c), stop = first + chunks.end(c); it != stop; ++it) {
+                f(*it);
+            }
+        });
+    }
+
+    template <class Iterator, class OutputIterator, class UnaryOp>
+    OutputIterator transform(Iterator first, Iterator last, OutputIterator d_first, UnaryOp op,
+                             size_t grain = default_grain, ThreadPool& pool = default_pool()) {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+        Chunks chunks(last - first, sizeof(T), grain);
+        pool.run(chunks.count(), [&](size_t c) {
+            OutputIterator out = d_first + chunks.begin(c);
+            for (Iterator it = first + chunks.begin(c), stop = first + chunks.end(c); it != stop; ++it, ++out) {
+                *out = op(*it);
+            }
+        });
+        return d_first + (last - first);
+    }
+
+    template <class Iterator, class T, class BinaryOp>
+    T reduce(Iterator first, Iterator last, T init, BinaryOp op, size_t grain = default_grain, ThreadPool& pool = default_pool()) {
+        using V = typename std::iterator_traits<Iterator>::value_type;
+        Chunks chunks(last - first, sizeof(V), grain);
+        // Every chunk is non-empty, so each partial starts from its first element
+        Vector<T> partials;
+        partials.reserve(chunks.count());
+        for (size_t c = 0; c < chunks.count(); c++) {
+            partials.emplace_back(*(first + chunks.begin(c)));
+        }
+        pool.run(chunks.count(), [&](size_t c) {
+            T& acc = partials[c];
+            for (Iterator it = first + chunks.begin(c) + 1, stop = first + chunks.end(c); it != stop; ++it) {
+                acc = op(acc, *it);
+            }
+        });
+        for (size_t c = 0; c < partials.size(); c++) {
+            init = op(init, partials[c]);
+        }
+        return init;
+    }
+
+    // d_first may be first to scan in place
+    template <class Iterator, class OutputIterator, class BinaryOp>
+    OutputIterator inclusive_scan(Iterator first, Iterator last, OutputIterator d_first, BinaryOp op,
+                                  size_t grain = default_grain, ThreadPool& pool = default_pool()) {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+        Chunks chunks(last - first, sizeof(T), grain);
+        size_t n_chunks = chunks.count();
+
+        // Pass 1: scan each chunk independently
+        pool.run(n_chunks, [&](size_t c) {
+            Iterator it = first + chunks.begin(c), stop = first + chunks.end(c);
+            OutputIterator out = d_first + chunks.begin(c);
+            T acc = *it;
+            *out = acc;
+            for (++it, ++out; it != stop; ++it, ++out) {
+                acc = op(acc, *it);
+                *out = acc;
+            }
+        });
+
+        // Carry the running total of everything before each chunk, in order
+        Vector<T> carries;
+        carries.reserve(n_chunks);
+        for (size_t c = 1; c < n_chunks; c++) {
+            const T& previous = *(d_first + (chunks.end(c - 1) - 1));
+            if (c == 1) {
+                carries.emplace_back(previous);
+            }
+            else {
+                carries.emplace_back(op(carries.back(), previous));
+            }
+        }
+
+        // Pass 2: fold the carry into every chunk but the first
+        pool.run(n_chunks - (n_chunks != 0), [&](size_t c) {
+            const T& carry = carries[c];
+            for (OutputIterator out = d_first + chunks.begin(c + 1), stop = d_first + chunks.end(c + 1); out != stop; ++out) {
+                *out = op(carry, *out);
+            }
+        });
+        return d_first + (last - first);
+    }
+}
+
+#endif
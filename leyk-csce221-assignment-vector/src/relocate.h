@@ -0,0 +1,34 @@
+#ifndef RELOCATE_H
+#define RELOCATE_H
+
+#include <cstddef> // size_t
+#include <cstring> // std::memmove
+#include <type_traits> // std::is_trivially_copyable
+
+/*
+    Relocation is a move followed by destroying the source. For most types
+    that is the same as copying the bytes and forgetting the source, which
+    lets the containers shift and reallocate elements with a single memmove
+    instead of a loop of moves.
+
+    Trivially copyable types are relocatable by default. Other types whose
+    moves only transfer ownership of a pointer (and whose moved-from state
+    needs no destructor work that the original didn't) can opt in:
+
+    template <>
+    struct is_trivially_relocatable<MyHandle> : std::true_type {};
+*/
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+// Moves the bytes of count objects from src to dest. The ranges may overlap.
+// Afterwards the objects live at dest and the source slots are raw memory.
+template <class T>
+void relocate_bytes(T* dest, const T* src, size_t count) noexcept {
+    static_assert(is_trivially_relocatable<T>::value, "Only trivially relocatable types can be moved bytewise");
+    if (count != 0) {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+    }
+}
+
+#endif
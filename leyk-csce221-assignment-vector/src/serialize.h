@@ -0,0 +1,465 @@
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include <algorithm> // std::min
+#include <cerrno> // errno
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <cstring> // std::memcmp, std::memcpy
+#include <fstream> // std::ifstream, std::ofstream
+#include <istream> // std::istream
+#include <ostream> // std::ostream
+#include <stdexcept> // std::out_of_range, std::runtime_error
+#include <string> // std::string
+#include <system_error> // std::system_error
+#include <type_traits> // std::is_trivially_copyable, std::enable_if_t
+
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+
+#include "Vector.h"
+
+/*
+    Binary serialization of Vectors
+    -------------------------------
+
+    save() writes a 64 byte header followed by the payload:
+
+        magic "VECSER01" | type tag | element size | count | payload bytes | checksum | leaf size
+
+    Trivially copyable elements are written as one raw block, so saving and
+    loading a Vector<double> is a single write or read of its buffer.
+    std::string elements are a 64-bit length followed by the bytes, and
+    nested Vectors are a 64-bit count followed by their elements in the
+    same encoding. The type tag records what kind of element was saved at
+    every level of nesting and the leaf size the width of the innermost
+    one, so loading a file as the wrong type fails instead of producing
+    garbage.
+    Numbers are stored in the native byte order.
+
+    load() reads a file back into a Vector and checks the checksum. map()
+    maps a file of trivially copyable elements and returns a read-only
+    view straight onto the page cache: nothing is copied and pages are read
+    on first touch.
+
+    Example:
+    {
+        Vector<double> prices = ...;
+        serial::save("prices.bin", prices);
+
+        Vector<double> copy = serial::load<double>("prices.bin");
+        serial::View<double> view = serial::map<double>("prices.bin");
+    }
+
+    Malformed or mismatched input throws std::runtime_error and failing
+    system calls throw std::system_error.
+*/
+namespace serial {
+
+    constexpr char magic[8] = {'V', 'E', 'C', 'S', 'E', 'R', '0', '1'};
+
+    struct Header {
+        char magic[8];
+        uint32_t tag;
+        uint32_t element_size;
+        uint64_t count;
+        uint64_t payload_bytes;
+        uint64_t checksum;
+        // sizeof the innermost element of nested Vectors
+        uint64_t leaf_size;
+    };
+
+    // The payload starts on a cache line so mapped elements are aligned
+    constexpr size_t header_bytes = 64;
+    static_assert(sizeof(Header) <= header_bytes, "Header must fit before the payload");
+
+    // A fast non-cryptographic 64-bit checksum over a byte stream, mixing a
+    // word at a time. Splitting the stream differently gives the same sum.
+    class Checksum {
+        uint64_t h;
+        uint64_t word;
+        size_t filled;
+        uint64_t length;
+
+        void mix(uint64_t w) noexcept {
+            h = (h ^ w) * 0x100000001b3ULL;
+            h ^= h >> 29;
+        }
+
+    public:
+        Checksum() noexcept : h(0xcbf29ce484222325ULL), word(0), filled(0), length(0) {}
+
+        void update(const void* data, size_t bytes) noexcept {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            length += bytes;
+            for (; filled != 0 && bytes != 0; p++, bytes--) {
+                word |= uint64_t(*p) << (8 * filled);
+                if (++filled == 8) {
+                    mix(word);
+                    word = 0;
+                    filled = 0;
+                }
+            }
+            for (; bytes >= 8; p += 8, bytes -= 8) {
+                uint64_t w;
+                std::memcpy(&w, p, 8);
+                mix(w);
+            }
+            for (; bytes != 0; p++, bytes--) {
+                word |= uint64_t(*p) << (8 * filled);
+                filled++;
+            }
+        }
+        uint64_t digest() const noexcept {
+            Checksum copy = *this;
+            if (copy.filled != 0) {
+                copy.mix(copy.word);
+            }
+            copy.mix(length);
+            return copy.h;
+        }
+    };
+
+    // Sinks take encoded bytes: Measure only counts and sums them, so a
+    // payload can be sized before it is written
+    class Measure {
+        Checksum sum;
+        uint64_t bytes;
+
+    public:
+        Measure() noexcept : bytes(0) {}
+        void write(const void* data, size_t count) noexcept {
+            sum.update(data, count);
+            bytes += count;
+        }
+        uint64_t size() const noexcept {
+            return bytes;
+        }
+        uint64_t checksum() const noexcept {
+            return sum.digest();
+        }
+    };
+
+    class StreamSink {
+        std::ostream& out;
+
+    public:
+        explicit StreamSink(std::ostream& out) noexcept : out(out) {}
+        void write(const void* data, size_t count) {
+            if (count != 0 && !out.write(static_cast<const char*>(data), static_cast<std::streamsize>(count))) {
+                throw std::runtime_error("serial: write failed");
+            }
+        }
+    };
+
+    // Sums the bytes it reads so the payload can be checked afterwards
+    class StreamSource {
+        std::istream& in;
+        Checksum sum;
+        uint64_t remaining;
+
+    public:
+        StreamSource(std::istream& in, uint64_t payload_bytes) noexcept : in(in), remaining(payload_bytes) {}
+        void read(void* data, size_t count) {
+            if (count > remaining) {
+                throw std::runtime_error("serial: payload is longer than the header says");
+            }
+            if (count != 0 && !in.read(static_cast<char*>(data), static_cast<std::streamsize>(count))) {
+                throw std::runtime_error("serial: payload is truncated");
+            }
+            sum.update(data, count);
+            remaining -= count;
+        }
+        uint64_t left() const noexcept {
+            return remaining;
+        }
+        uint64_t checksum() const noexcept {
+            return sum.digest();
+        }
+    };
+
+    // How each element type is encoded. tag identifies the type and
+    // leaf_size the width of its innermost element, write encodes count
+    // elements and read appends count decoded elements.
+    template <class T, class = void>
+    struct codec;
+
+    template <class T>
+    struct codec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+        // Integers, floating point and other raw records are told apart,
+        // the element size tells widths apart
+        static constexpr uint32_t tag = std::is_floating_point<T>::value ? 3
+                                      : std::is_integral<T>::value ? (std::is_signed<T>::value ? 1 : 2)
+                                      : 4;
+        static constexpr uint64_t leaf_size = sizeof(T);
+
+        template <class Sink>
+        static void write(Sink& sink, const T* data, size_t count) {
+            sink.write(data, count * sizeof(T));
+        }
+        template <class Source>
+        static void read(Source& source, Vector<T>& out, size_t count) {
+            if (count == 0) {
+                return;
+            }
+            if (count > source.left() / sizeof(T)) {
+                throw std::runtime_error("serial: count is larger than the payload");
+            }
+            size_t old_size = out.size();
+            out.resize(old_size + count);
+            source.read(&out[old_size], count * sizeof(T));
+        }
+    };
+
+    template <>
+    struct codec<std::string> {
+        static constexpr uint32_t tag = 5;
+        static constexpr uint64_t leaf_size = sizeof(char);
+
+        template <class Sink>
+        static void write(Sink& sink, const std::string* data, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                uint64_t length = data[i].size();
+                sink.write(&length, sizeof(length));
+                sink.write(data[i].data(), data[i].size());
+            }
+        }
+        template <class Source>
+        static void read(Source& source, Vector<std::string>& out, size_t count) {
+            out.reserve(out.size() + std::min<uint64_t>(count, source.left() / sizeof(uint64_t)));
+            for (size_t i = 0; i < count; i++) {
+                uint64_t length;
+                source.read(&length, sizeof(length));
+                if (length > source.left()) {
+                    throw std::runtime_error("serial: string is longer than the payload");
+                }
+                std::string& value = out.emplace_back(length, '\0');
+                source.read(&value[0], length);
+            }
+        }
+    };
+
+    template <class U>
+    struct codec<Vector<U>> {
+        // The element's tag goes in the higher bits, one byte per level
+        static_assert(codec<U>::tag < (uint32_t(1) << 24), "Vectors are nested too deep for the type tag");
+        static constexpr uint32_t tag = 6 | (codec<U>::tag << 8);
+        static constexpr uint64_t leaf_size = codec<U>::leaf_size;
+
+        template <class Sink>
+        static void write(Sink& sink, const Vector<U>* data, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                uint64_t size = data[i].size();
+                sink.write(&size, sizeof(size));
+                if (size != 0) {
+                    codec<U>::write(sink, &data[i][0], size);
+                }
+            }
+        }
+        template <class Source>
+        static void read(Source& source, Vector<Vector<U>>& out, size_t count) {
+            out.reserve(out.size() + std::min<uint64_t>(count, source.left() / sizeof(uint64_t)));
+            for (size_t i = 0; i < count; i++) {
+                uint64_t size;
+                source.read(&size, sizeof(size));
+                codec<U>::read(source, out.emplace_back(), size);
+            }
+        }
+    };
+
+    template <class T>
+    void save(std::ostream& out, const Vector<T>& vec) {
+        const T* data = vec.empty() ? nullptr : &vec[0];
+
+        Header header = {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.tag = codec<T>::tag;
+        header.element_size = sizeof(T);
+        header.leaf_size = codec<T>::leaf_size;
+        header.count = vec.size();
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            Checksum sum;
+            sum.update(data, vec.size() * sizeof(T));
+            header.payload_bytes = vec.size() * sizeof(T);
+            header.checksum = sum.digest();
+        }
+        else {
+            // Variable length encodings are sized and summed in a dry run
+            Measure measure;
+            codec<T>::write(measure, data, vec.size());
+            header.payload_bytes = measure.size();
+            header.checksum = measure.checksum();
+        }
+
+        char block[header_bytes] = {};
+        std::memcpy(block, &header, sizeof(header));
+        StreamSink sink(out);
+        sink.write(block, sizeof(block));
+        codec<T>::write(sink, data, vec.size());
+    }
+    template <class T>
+    void save(const std::string& path, const Vector<T>& vec) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("serial: cannot open " + path);
+        }
+        save(out, vec);
+        if (!out.flush()) {
+            throw std::runtime_error("serial: cannot write " + path);
+        }
+    }
+
+    // Checks that header describes a Vector<T>
+    template <class T>
+    void check(const Header& header) {
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("serial: not a serialized Vector");
+        }
+        if (header.tag != codec<T>::tag || header.element_size != sizeof(T) || header.leaf_size != codec<T>::leaf_size) {
+            throw std::runtime_error("serial: saved with a different element type");
+        }
+        if (std::is_trivially_copyable<T>::value && header.payload_bytes / sizeof(T) != header.count) {
+            throw std::runtime_error("serial: payload does not match the count");
+        }
+    }
+
+    template <class T>
+    Vector<T> load(std::istream& in) {
+        char block[header_bytes];
+        if (!in.read(block, sizeof(block))) {
+            throw std::runtime_error("serial: header is truncated");
+        }
+        Header header;
+        std::memcpy(&header, block, sizeof(header));
+        check<T>(header);
+
+        Vector<T> vec;
+        StreamSource source(in, header.payload_bytes);
+        codec<T>::read(source, vec, header.count);
+        if (source.left() != 0 || source.checksum() != header.checksum) {
+            throw std::runtime_error("serial: checksum mismatch");
+        }
+        return vec;
+    }
+    template <class T>
+    Vector<T> load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("serial: cannot open " + path);
+        }
+        return load<T>(in);
+    }
+
+    // A read-only view of the elements of a mapped file, valid for as long
+    // as the View lives
+    template <class T>
+    class View {
+        static_assert(std::is_trivially_copyable<T>::value, "Only raw payloads can be mapped");
+
+        void* map;
+        size_t map_bytes;
+        size_t _size;
+
+        const T* data() const noexcept {
+            return reinterpret_cast<const T*>(static_cast<const char*>(map) + header_bytes);
+        }
+
+    public:
+        View(void* map, size_t map_bytes, size_t size) noexcept : map(map), map_bytes(map_bytes), _size(size) {}
+        View(const View&) = delete;
+        View& operator=(const View&) = delete;
+        View(View&& other) noexcept : map(other.map), map_bytes(other.map_bytes), _size(other._size) {
+            other.map = nullptr;
+            other._size = 0;
+        }
+        View& operator=(View&& other) noexcept {
+            if (this == &other) {
+                return *this;
+            }
+            if (map != nullptr) {
+                munmap(map, map_bytes);
+            }
+            map = other.map;
+            map_bytes = other.map_bytes;
+            _size = other._size;
+            other.map = nullptr;
+            other._size = 0;
+            return *this;
+        }
+        ~View() {
+            if (map != nullptr) {
+                munmap(map, map_bytes);
+            }
+        }
+
+        const T* begin() const noexcept {
+            return data();
+        }
+        const T* end() const noexcept {
+            return data() + _size;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+        size_t size() const noexcept {
+            return _size;
+        }
+        const T& at(size_t pos) const {
+            if (pos >= _size) {
+                throw std::out_of_range("error");
+            }
+            return data()[pos];
+        }
+        const T& operator[](size_t pos) const {
+            return data()[pos];
+        }
+    };
+
+    // Maps a file written by save(). verify reads the whole payload once to
+    // check the checksum; without it pages are only read when touched.
+    template <class T>
+    View<T> map(const std::string& path, bool verify = false) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+        size_t bytes = static_cast<size_t>(st.st_size);
+        if (bytes < header_bytes) {
+            close(fd);
+            throw std::runtime_error("serial: " + path + " is too short to have a header");
+        }
+        void* ptr = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        int error = errno;
+        // The mapping keeps the file alive
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+
+        Header header;
+        std::memcpy(&header, ptr, sizeof(header));
+        View<T> view(ptr, bytes, header.count);
+        check<T>(header);
+        if (header.payload_bytes > bytes - header_bytes) {
+            throw std::runtime_error("serial: " + path + " is truncated");
+        }
+        if (verify) {
+            Checksum sum;
+            sum.update(view.begin(), header.payload_bytes);
+            if (sum.digest() != header.checksum) {
+                throw std::runtime_error("serial: checksum mismatch");
+            }
+        }
+        return view;
+    }
+}
+
+#endif
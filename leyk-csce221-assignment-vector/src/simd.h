@@ -0,0 +1,358 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstring> // std::memcpy
+#include <type_traits> // std::enable_if, std::is_integral, std::is_same
+#include <utility> // std::pair
+
+/*
+    SIMD kernels for Vectors of arithmetic types
+    --------------------------------------------
+
+    Vectorized find, count, fill, minmax, accumulate and equal over
+    Vector<T>::iterator ranges (or raw pointers) where T is an integral type
+    other than bool, float or double.
+
+    The kernels are written once against GCC/Clang vector extensions and
+    instantiated for 16 byte (SSE2) and 32 byte (AVX2) registers. The widest
+    instruction set the CPU supports is picked on first use. Other compilers
+    get the scalar loops. Other element types do not compile.
+
+    Example:
+    {
+        Vector<float> column = ...;
+
+        auto it = simd::find(column.begin(), column.end(), 3.0f);
+        float total = simd::accumulate(column.begin(), column.end(), 0.0f);
+        std::pair<float, float> range = simd::minmax(column.begin(), column.end());
+    }
+
+    accumulate adds each lane separately and combines the lanes at the end,
+    so for floating point types the result can differ from a strict
+    left-to-right sum in the last bits. Integer sums are exact.
+*/
+namespace simd {
+
+    enum class isa {
+        scalar,
+        sse2,
+        avx2
+    };
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#endif
+#if defined(__GNUC__)
+#define SIMD_VECTOR_EXTENSIONS 1
+#endif
+
+    inline isa detect_isa() noexcept {
+#ifdef SIMD_X86
+        if (__builtin_cpu_supports("avx2")) {
+            return isa::avx2;
+        }
+        return isa::sse2;
+#elif defined(SIMD_VECTOR_EXTENSIONS)
+        // 16 byte vectors lower to the native registers (e.g. NEON)
+        return isa::sse2;
+#else
+        return isa::scalar;
+#endif
+    }
+
+    class dispatch {
+        static isa& current() noexcept {
+            static isa selected = detect_isa();
+            return selected;
+        }
+
+        friend isa selected_isa() noexcept;
+        friend isa select_isa(isa requested) noexcept;
+    };
+
+    // The instruction set the kernels dispatch to
+    inline isa selected_isa() noexcept {
+        return dispatch::current();
+    }
+    // Can be lowered (e.g. to compare paths in tests) but not raised past
+    // what detect_isa() found; a higher request is clamped to it. Returns
+    // the instruction set now selected.
+    inline isa select_isa(isa requested) noexcept {
+        static const isa detected = detect_isa();
+        dispatch::current() = requested < detected ? requested : detected;
+        return dispatch::current();
+    }
+
+    // (smallest, largest)
+    template <class T>
+    using range = std::pair<T, T>;
+
+    template <class T>
+    struct is_vectorizable
+    : std::integral_constant<bool, (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+                                   || std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+    template <class T, class Result>
+    using enable_if_vectorizable = typename std::enable_if<is_vectorizable<T>::value, Result>::type;
+
+    namespace scalar {
+        template <class T>
+        const T* find(const T* first, const T* last, T value) noexcept {
+            for (; first != last; ++first) {
+                if (*first == value) {
+                    break;
+                }
+            }
+            return first;
+        }
+        template <class T>
+        size_t count(const T* first, const T* last, T value) noexcept {
+            size_t total = 0;
+            for (; first != last; ++first) {
+                total += *first == value;
+            }
+            return total;
+        }
+        template <class T>
+        void fill(T* first, T* last, T value) noexcept {
+            for (; first != last; ++first) {
+                *first = value;
+            }
+        }
+        template <class T>
+        std::pair<T, T> minmax(const T* first, const T* last) noexcept {
+            std::pair<T, T> result(*first, *first);
+            for (++first; first != last; ++first) {
+                if (*first < result.first) {
+                    result.first = *first;
+                }
+                if (result.second < *first) {
+                    result.second = *first;
+                }
+            }
+            return result;
+        }
+        template <class T>
+        T accumulate(const T* first, const T* last, T init) noexcept {
+            for (; first != last; ++first) {
+                init += *first;
+            }
+            return init;
+        }
+        template <class T>
+        bool equal(const T* first1, const T* last1, const T* first2) noexcept {
+            for (; first1 != last1; ++first1, ++first2) {
+                if (!(*first1 == *first2)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+#ifdef SIMD_VECTOR_EXTENSIONS
+    // Generic kernels over Bytes-wide registers. They are always inlined into
+    // the per-ISA entry points below, which is where the target instruction
+    // set is chosen. Loads and stores go through memcpy, which compiles to
+    // unaligned vector moves.
+    template <class T, size_t Bytes>
+    struct kernels {
+        static_assert(is_vectorizable<T>::value, "Vector extensions need an unpadded arithmetic lane type");
+
+        typedef T vec __attribute__((vector_size(Bytes)));
+        typedef decltype(vec() == vec()) mask;
+        static constexpr size_t lanes = Bytes / sizeof(T);
+
+        __attribute__((always_inline)) static bool any(const mask& m) noexcept {
+            uint64_t words[Bytes / sizeof(uint64_t)];
+            std::memcpy(words, &m, Bytes);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < Bytes / sizeof(uint64_t); i++) {
+                bits |= words[i];
+            }
+            return bits != 0;
+        }
+
+        __attribute__((always_inline)) static const T* find(const T* first, const T* last, T value) noexcept {
+            vec needle = value - vec{};
+            for (; static_cast<size_t>(last - first) >= lanes; first += lanes) {
+                vec chunk;
+                std::memcpy(&chunk, first, Bytes);
+                if (any(chunk == needle)) {
+                    break;
+                }
+            }
+            return scalar::find(first, last, value);
+        }
+        __attribute__((always_inline)) static size_t count(const T* first, const T* last, T value) noexcept {
+            vec needle = value - vec{};
+            size_t total = 0;
+            while (static_cast<size_t>(last - first) >= lanes) {
+                // Matches are -1 per lane, so a lane as narrow as a byte can
+                // only absorb 127 of them before it has to be flushed
+                mask hits = {};
+                for (size_t i = 0; i < 127 && static_cast<size_t>(last - first) >= lanes; i++, first += lanes) {
+                    vec chunk;
+                    std::memcpy(&chunk, first, Bytes);
+                    hits -= (chunk == needle);
+                }
+                for (size_t lane = 0; lane < lanes; lane++) {
+                    total += static_cast<size_t>(hits[lane]);
+                }
+            }
+            return total + scalar::count(first, last, value);
+        }
+        __attribute__((always_inline)) static void fill(T* first, T* last, T value) noexcept {
+            vec chunk = value - vec{};
+            for (; static_cast<size_t>(last - first) >= lanes; first += lanes) {
+                std::memcpy(first, &chunk, Bytes);
+            }
+            scalar::fill(first, last, value);
+        }
+        __attribute__((always_inline)) static std::pair<T, T> minmax(const T* first, const T* last) noexcept {
+            if (static_cast<size_t>(last - first) < lanes) {
+                return scalar::minmax(first, last);
+            }
+            vec lo, hi;
+            std::memcpy(&lo, first, Bytes);
+            hi = lo;
+            for (first += lanes; static_cast<size_t>(last - first) >= lanes; first += lanes) {
+                vec chunk;
+                std::memcpy(&chunk, first, Bytes);
+                lo = chunk < lo ? chunk : lo;
+                hi = hi < chunk ? chunk : hi;
+            }
+            std::pair<T, T> result(lo[0], hi[0]);
+            for (size_t lane = 1; lane < lanes; lane++) {
+                result.first = lo[lane] < result.first ? lo[lane] : result.first;
+                result.second = result.second < hi[lane] ? hi[lane] : result.second;
+            }
+            if (first != last) {
+                std::pair<T, T> tail = scalar::minmax(first, last);
+                result.first = tail.first < result.first ? tail.first : result.first;
+                result.second = result.second < tail.second ? tail.second : result.second;
+            }
+            return result;
+        }
+        __attribute__((always_inline)) static T accumulate(const T* first, const T* last, T init) noexcept {
+            vec sum = {};
+            for (; static_cast<size_t>(last - first) >= lanes; first += lanes) {
+                vec chunk;
+                std::memcpy(&chunk, first, Bytes);
+                sum += chunk;
+            }
+            for (size_t lane = 0; lane < lanes; lane++) {
+                init += sum[lane];
+            }
+            return scalar::accumulate(first, last, init);
+        }
+        __attribute__((always_inline)) static bool equal(const T* first1, const T* last1, const T* first2) noexcept {
+            for (; static_cast<size_t>(last1 - first1) >= lanes; first1 += lanes, first2 += lanes) {
+                vec a, b;
+                std::memcpy(&a, first1, Bytes);
+                std::memcpy(&b, first2, Bytes);
+                if (any(a != b)) {
+                    return false;
+                }
+            }
+            return scalar::equal(first1, last1, first2);
+        }
+    };
+
+    // One entry point per kernel and instruction set
+#ifdef SIMD_X86
+#define SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SIMD_AVX2_TARGET
+#endif
+#define SIMD_ENTRY_POINTS(name, ret, params, args)                                                 \
+    template <class T> ret name##_sse2 params noexcept { return kernels<T, 16>::name args; }      \
+    template <class T> SIMD_AVX2_TARGET ret name##_avx2 params noexcept { return kernels<T, 32>::name args; }
+
+    SIMD_ENTRY_POINTS(find, const T*, (const T* first, const T* last, T value), (first, last, value))
+    SIMD_ENTRY_POINTS(count, size_t, (const T* first, const T* last, T value), (first, last, value))
+    SIMD_ENTRY_POINTS(fill, void, (T* first, T* last, T value), (first, last, value))
+    SIMD_ENTRY_POINTS(minmax, range<T>, (const T* first, const T* last), (first, last))
+    SIMD_ENTRY_POINTS(accumulate, T, (const T* first, const T* last, T init), (first, last, init))
+    SIMD_ENTRY_POINTS(equal, bool, (const T* first1, const T* last1, const T* first2), (first1, last1, first2))
+
+#undef SIMD_ENTRY_POINTS
+#undef SIMD_AVX2_TARGET
+
+#define SIMD_DISPATCH(name, ...)                          \
+    switch (selected_isa()) {                             \
+    case isa::avx2: return name##_avx2(__VA_ARGS__);      \
+    case isa::sse2: return name##_sse2(__VA_ARGS__);      \
+    default: return scalar::name(__VA_ARGS__);            \
+    }
+#else
+#define SIMD_DISPATCH(name, ...) return scalar::name(__VA_ARGS__);
+#endif
+
+    template <class T>
+    enable_if_vectorizable<T, const T*> find(const T* first, const T* last, T value) noexcept {
+        SIMD_DISPATCH(find, first, last, value)
+    }
+    template <class T>
+    enable_if_vectorizable<T, size_t> count(const T* first, const T* last, T value) noexcept {
+        SIMD_DISPATCH(count, first, last, value)
+    }
+    template <class T>
+    enable_if_vectorizable<T, void> fill(T* first, T* last, T value) noexcept {
+        SIMD_DISPATCH(fill, first, last, value)
+    }
+    // Requires a non-empty range
+    template <class T>
+    enable_if_vectorizable<T, range<T>> minmax(const T* first, const T* last) noexcept {
+        SIMD_DISPATCH(minmax, first, last)
+    }
+    template <class T>
+    enable_if_vectorizable<T, T> accumulate(const T* first, const T* last, T init) noexcept {
+        SIMD_DISPATCH(accumulate, first, last, init)
+    }
+    template <class T>
+    enable_if_vectorizable<T, bool> equal(const T* first1, const T* last1, const T* first2) noexcept {
+        SIMD_DISPATCH(equal, first1, last1, first2)
+    }
+
+#undef SIMD_DISPATCH
+
+    // Iterator front ends. iterator::operator-> hands back the raw pointer
+    // without dereferencing, so it is safe on end().
+    template <class Iterator>
+    using enable_for = typename std::enable_if<is_vectorizable<typename Iterator::value_type>::value
+                                               && std::is_same<typename Iterator::pointer, typename Iterator::value_type*>::value,
+                                               Iterator>::type;
+
+    template <class Iterator>
+    enable_for<Iterator> find(Iterator first, Iterator last, typename Iterator::value_type value) noexcept {
+        return first + (find(first.operator->(), last.operator->(), value) - first.operator->());
+    }
+    template <class Iterator>
+    size_t count(Iterator first, enable_for<Iterator> last, typename Iterator::value_type value) noexcept {
+        return count(static_cast<const typename Iterator::value_type*>(first.operator->()), last.operator->(), value);
+    }
+    template <class Iterator>
+    void fill(Iterator first, enable_for<Iterator> last, typename Iterator::value_type value) noexcept {
+        fill(first.operator->(), last.operator->(), value);
+    }
+    template <class Iterator>
+    std::pair<typename Iterator::value_type, typename Iterator::value_type> minmax(Iterator first, enable_for<Iterator> last) noexcept {
+        return minmax(static_cast<const typename Iterator::value_type*>(first.operator->()), last.operator->());
+    }
+    template <class Iterator>
+    typename Iterator::value_type accumulate(Iterator first, enable_for<Iterator> last, typename Iterator::value_type init) noexcept {
+        return accumulate(static_cast<const typename Iterator::value_type*>(first.operator->()), last.operator->(), init);
+    }
+    template <class Iterator>
+    bool equal(Iterator first1, enable_for<Iterator> last1, Iterator first2) noexcept {
+        return equal(static_cast<const typename Iterator::value_type*>(first1.operator->()), last1.operator->(), first2.operator->());
+    }
+}
+
+#undef SIMD_VECTOR_EXTENSIONS
+#undef SIMD_X86
+
+#endif
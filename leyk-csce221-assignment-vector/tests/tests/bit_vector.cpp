@@ -0,0 +1,170 @@
+#include "executable.h"
+#include "BitVector.h"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+// Iterators only convert towards const, and const ones yield plain bools
+static_assert(std::is_convertible<BitVector::iterator, BitVector::const_iterator>::value, "");
+static_assert(!std::is_convertible<BitVector::const_iterator, BitVector::iterator>::value, "");
+static_assert(std::is_same<decltype(*std::declval<BitVector::const_iterator>()), bool>::value, "");
+
+namespace {
+    bool matches(const std::vector<bool> & gt, const BitVector & bits) {
+        if(gt.size() != bits.size())
+            return false;
+        for(size_t i = 0; i < gt.size(); i++)
+            if(gt[i] != bits[i])
+                return false;
+        return true;
+    }
+}
+
+TEST(bit_vector_push_back_access) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        BitVector bits;
+        std::vector<bool> gt;
+        for(size_t i = 0; i < sz; i++) {
+            bool b = t.range<int>(0, 2);
+            gt.push_back(b);
+            bits.push_back(b);
+        }
+        ASSERT_TRUE(matches(gt, bits));
+        ASSERT_EQ(sz == 0, bits.empty());
+        ASSERT_EXCEPTION(bits.at(sz), std::out_of_range);
+
+        // Eight times smaller than one byte per flag
+        ASSERT_GE((sz + 63) / 64 * 64 * 2, bits.capacity());
+
+        // Writing through the proxy and iterating
+        for(auto it = bits.begin(); it != bits.end(); ++it)
+            (*it).flip();
+        size_t i = 0;
+        for(auto it = bits.begin(); it != bits.end(); it++, i++)
+            ASSERT_EQ(!gt[i], static_cast<bool>(*it));
+
+        // A const bitmap iterates and works with the std algorithms
+        const BitVector & view = bits;
+        i = 0;
+        for(bool b : view)
+            ASSERT_EQ(!gt[i++], b);
+        ASSERT_EQ(sz, i);
+        ASSERT_EQ(static_cast<ptrdiff_t>(view.count()), std::count(view.begin(), view.end(), true));
+        ASSERT_TRUE(std::equal(view.cbegin(), view.cend(), bits.begin()));
+        BitVector::const_iterator mixed = bits.begin();
+        ASSERT_TRUE(mixed == view.begin());
+
+        while(!gt.empty()) {
+            gt.pop_back();
+            bits.pop_back();
+        }
+        ASSERT_TRUE(bits.empty());
+        ASSERT_FALSE(bits.any());
+    }
+}
+
+TEST(bit_vector_insert_erase) {
+    Typegen t;
+
+    for(size_t k = 0; k < 200; k++) {
+        size_t sz = t.range<size_t>(0x1FF);
+        BitVector bits;
+        std::vector<bool> gt;
+        for(size_t i = 0; i < sz; i++) {
+            bool b = t.range<int>(0, 2);
+            gt.push_back(b);
+            bits.push_back(b);
+        }
+
+        for(size_t j = 0; j < 5; j++) {
+            size_t pos = t.range<size_t>(0, gt.size() + 1);
+            size_t count = t.range<size_t>(0, 150);
+            bool value = t.range<int>(0, 2);
+            gt.insert(gt.begin() + pos, count, value);
+            auto it = bits.insert(bits.begin() + pos, count, value);
+            ASSERT_TRUE(it == bits.begin() + pos);
+            ASSERT_TRUE(matches(gt, bits));
+
+            pos = t.range<size_t>(0, gt.size() + 1);
+            bits.insert(bits.begin() + pos, !value);
+            gt.insert(gt.begin() + pos, !value);
+
+            size_t first = t.range<size_t>(0, gt.size() + 1);
+            size_t last = t.range<size_t>(first, gt.size() + 1);
+            gt.erase(gt.begin() + first, gt.begin() + last);
+            bits.erase(bits.begin() + first, bits.begin() + last);
+            ASSERT_TRUE(matches(gt, bits));
+
+            if(!gt.empty()) {
+                pos = t.range<size_t>(0, gt.size());
+                gt.erase(gt.begin() + pos);
+                bits.erase(bits.begin() + pos);
+            }
+            ASSERT_TRUE(matches(gt, bits));
+        }
+    }
+}
+
+TEST(bit_vector_resize) {
+    Typegen t;
+
+    for(size_t k = 0; k < 200; k++) {
+        size_t sz = t.range<size_t>(0x1FF);
+        bool init = t.range<int>(0, 2);
+        BitVector bits(sz, init);
+        std::vector<bool> gt(sz, init);
+        ASSERT_TRUE(matches(gt, bits));
+
+        size_t count = t.range<size_t>(0x1FF);
+        bool value = t.range<int>(0, 2);
+        gt.resize(count, value);
+        bits.resize(count, value);
+        ASSERT_TRUE(matches(gt, bits));
+        ASSERT_EQ(static_cast<size_t>(std::count(gt.begin(), gt.end(), true)), bits.count());
+    }
+}
+
+TEST(bit_vector_word_operations) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFFF);
+        BitVector a(sz), b(sz);
+        std::vector<bool> ga(sz), gb(sz);
+        // Sparse, so the searches skip whole words
+        for(size_t i = 0; i < sz; i++) {
+            ga[i] = a[i] = t.range<int>(0, 50) == 0;
+            gb[i] = b[i] = t.range<int>(0, 2);
+        }
+
+        size_t expected = std::count(ga.begin(), ga.end(), true);
+        ASSERT_EQ(expected, a.count());
+        ASSERT_EQ(expected != 0, a.any());
+        ASSERT_EQ(expected == 0, a.none());
+        ASSERT_EQ(expected == sz, a.all());
+
+        std::vector<size_t> set;
+        for(size_t i = a.find_first(); i < a.size(); i = a.find_next(i))
+            set.push_back(i);
+        ASSERT_EQ(expected, set.size());
+        for(size_t i : set)
+            ASSERT_TRUE(ga[i]);
+
+        BitVector and_ = a & b, or_ = a | b, xor_ = a ^ b, not_ = ~a;
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_EQ(ga[i] && gb[i], and_[i]);
+            ASSERT_EQ(ga[i] || gb[i], or_[i]);
+            ASSERT_EQ(ga[i] != gb[i], xor_[i]);
+            ASSERT_EQ(!ga[i], not_[i]);
+        }
+        // Bits past the end stay clear
+        ASSERT_EQ(sz - expected, not_.count());
+        ASSERT_TRUE(~not_ == a);
+
+        BitVector shorter(sz + 1);
+        ASSERT_EXCEPTION(a &= shorter, std::invalid_argument);
+    }
+}
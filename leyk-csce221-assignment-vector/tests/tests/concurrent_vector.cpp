@@ -0,0 +1,102 @@
+#include "executable.h"
+#include "ConcurrentVector.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "box.h"
+
+TEST(concurrent_vector_single_thread) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x1FFF);
+        ConcurrentVector<Box<int>, 3> vec;
+        std::vector<int> gt;
+
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            gt.push_back(el);
+            ASSERT_EQ(i, vec.emplace_back(el));
+        }
+
+        ASSERT_EQ(sz, vec.size());
+        ASSERT_EQ(sz == 0, vec.empty());
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_TRUE(vec.published(i));
+            ASSERT_EQ(gt[i], *vec[i]);
+        }
+        ASSERT_FALSE(vec.published(sz));
+        ASSERT_EXCEPTION(vec.at(sz), std::out_of_range);
+
+        vec.clear();
+        ASSERT_TRUE(vec.empty());
+        vec.push_back(Box<int>(1));
+        ASSERT_EQ(1, *vec.at(0));
+    }
+}
+
+TEST(concurrent_vector_stable_addresses) {
+    ConcurrentVector<long, 2> vec;
+    std::vector<long*> addresses;
+
+    for(size_t i = 0; i < 10000; i++) {
+        vec.push_back(static_cast<long>(i));
+        addresses.push_back(&vec[i]);
+    }
+    for(size_t i = 0; i < 10000; i++) {
+        ASSERT_EQ(addresses[i], &vec[i]);
+        ASSERT_EQ(static_cast<long>(i), vec[i]);
+    }
+}
+
+TEST(concurrent_vector_reserve) {
+    ConcurrentVector<int, 4> vec;
+    vec.reserve(1000);
+
+    Memhook mh;
+    for(int i = 0; i < 1000; i++)
+        vec.push_back(i);
+    mh.disable();
+    ASSERT_EQ_(0UL, mh.n_allocs(), "Reserved buckets should be reused");
+}
+
+TEST(concurrent_vector_parallel_push_back) {
+    const size_t n_threads = 8;
+    const size_t per_thread = 50000;
+
+    for(size_t k = 0; k < 10; k++) {
+        ConcurrentVector<size_t, 4> vec;
+        std::atomic<bool> done(false);
+        std::atomic<size_t> seen(0);
+
+        // Reads published elements while the writers are still appending
+        std::thread reader([&] {
+            while(!done.load()) {
+                size_t sz = vec.size();
+                for(size_t i = 0; i < sz; i++)
+                    if(vec.published(i) && vec[i] % per_thread < per_thread)
+                        seen++;
+            }
+        });
+
+        std::vector<std::thread> writers;
+        for(size_t w = 0; w < n_threads; w++)
+            writers.emplace_back([&, w] {
+                for(size_t i = 0; i < per_thread; i++)
+                    vec.push_back(w * per_thread + i);
+            });
+        for(std::thread & writer : writers)
+            writer.join();
+        done = true;
+        reader.join();
+
+        // Every value shows up exactly once
+        ASSERT_EQ(n_threads * per_thread, vec.size());
+        std::vector<bool> found(n_threads * per_thread, false);
+        for(size_t i = 0; i < vec.size(); i++) {
+            ASSERT_TRUE(vec.published(i));
+            ASSERT_FALSE(found[vec[i]]);
+            found[vec[i]] = true;
+        }
+    }
+}
@@ -0,0 +1,248 @@
+#include "executable.h"
+#include "FlatMap.h"
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Iterators only convert towards const
+static_assert(std::is_convertible<FlatMap<int, int>::iterator, FlatMap<int, int>::const_iterator>::value, "");
+static_assert(!std::is_convertible<FlatMap<int, int>::const_iterator, FlatMap<int, int>::iterator>::value, "");
+
+namespace {
+    // A key whose copies throw once the budget runs out
+    struct Fragile {
+        static int budget;
+        int key;
+        Fragile(int key) : key(key) {}
+        Fragile(const Fragile & other) : key(other.key) {
+            if(budget-- == 0)
+                throw std::runtime_error("copy");
+        }
+        Fragile & operator=(const Fragile &) = default;
+        bool operator<(const Fragile & other) const { return key < other.key; }
+    };
+    int Fragile::budget = -1;
+
+    bool matches(const std::map<int, int> & gt, FlatMap<int, int> & map) {
+        if(gt.size() != map.size())
+            return false;
+        auto it = map.begin();
+        for(const auto & entry : gt) {
+            if(it->first != entry.first || it->second != entry.second)
+                return false;
+            ++it;
+        }
+        return it == map.end();
+    }
+}
+
+TEST(flat_map_insert_find) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        std::map<int, int> gt;
+        FlatMap<int, int> map;
+        for(size_t i = 0; i < sz; i++) {
+            int key = t.range<int>(0, 512);
+            int value = t.get<int>();
+            bool inserted = gt.insert({key, value}).second;
+            auto result = map.insert(key, value);
+            ASSERT_EQ(inserted, result.second);
+            ASSERT_EQ(key, result.first->first);
+            ASSERT_EQ(gt[key], result.first->second);
+        }
+        ASSERT_TRUE(matches(gt, map));
+
+        for(int key = -1; key <= 512; key++) {
+            ASSERT_EQ(gt.count(key), map.count(key));
+            auto it = map.find(key);
+            if(gt.count(key)) {
+                ASSERT_EQ(gt[key], it->second);
+                ASSERT_EQ(gt[key], map.at(key));
+            }
+            else {
+                ASSERT_TRUE(it == map.end());
+                ASSERT_EXCEPTION(map.at(key), std::out_of_range);
+            }
+            ASSERT_EQ(std::distance(gt.begin(), gt.lower_bound(key)), map.lower_bound(key) - map.begin());
+            ASSERT_EQ(std::distance(gt.begin(), gt.upper_bound(key)), map.upper_bound(key) - map.begin());
+        }
+    }
+}
+
+TEST(flat_map_subscript_erase) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        std::map<int, int> gt;
+        FlatMap<int, int> map;
+        for(size_t i = 0; i < sz; i++) {
+            int key = t.range<int>(0, 256);
+            int value = t.get<int>();
+            switch(t.range<int>(0, 3)) {
+                case 0:
+                    gt[key] += value;
+                    map[key] += value;
+                    break;
+                case 1:
+                    gt[key] = value;
+                    ASSERT_EQ(value, map.insert_or_assign(key, value).first->second);
+                    break;
+                default:
+                    ASSERT_EQ(gt.erase(key), map.erase(key));
+            }
+        }
+        ASSERT_TRUE(matches(gt, map));
+
+        // Erasing through an iterator returns the next entry
+        while(!map.empty()) {
+            auto it = map.begin() + t.range<size_t>(map.size());
+            int next = it + 1 == map.end() ? -1 : (it + 1)->first;
+            gt.erase(it->first);
+            it = map.erase(it);
+            ASSERT_EQ(next, it == map.end() ? -1 : it->first);
+        }
+        ASSERT_TRUE(gt.empty());
+    }
+}
+
+TEST(flat_map_bulk_insert) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        std::map<int, int> gt;
+        FlatMap<int, int> map;
+        for(size_t round = 0; round < 4; round++) {
+            size_t sz = t.range<size_t>(0x1FF);
+            std::vector<std::pair<int, int>> batch;
+            for(size_t i = 0; i < sz; i++)
+                batch.push_back({t.range<int>(0, 1024), t.get<int>()});
+
+            // The first of a repeated key wins, including over existing entries
+            for(const auto & entry : batch)
+                gt.insert(entry);
+            map.insert(batch.begin(), batch.end());
+            ASSERT_TRUE(matches(gt, map));
+        }
+    }
+}
+
+TEST(flat_map_insert_unsorted) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        std::map<std::string, size_t> gt;
+        FlatMap<std::string, size_t> map;
+        for(size_t i = 0; i < sz; i++) {
+            std::string key = std::to_string(t.range<int>(0, 512));
+            gt.insert({key, i});
+            map.insert_unsorted(key, i);
+        }
+
+        // Reads through a const reference sort the pending entries too
+        const FlatMap<std::string, size_t> & view = map;
+        auto cit = view.begin();
+        for(const auto & entry : gt) {
+            ASSERT_TRUE(entry.first == cit->first);
+            ASSERT_EQ(entry.second, cit->second);
+            ++cit;
+        }
+        ASSERT_TRUE(cit == view.end());
+        ASSERT_EQ(gt.size(), view.size());
+        for(const auto & entry : gt) {
+            ASSERT_TRUE(view.contains(entry.first));
+            ASSERT_EQ(entry.second, view.at(entry.first));
+            ASSERT_EQ(entry.second, view.find(entry.first)->second);
+        }
+
+        auto it = map.begin();
+        for(const auto & entry : gt) {
+            ASSERT_TRUE(entry.first == it.key());
+            ASSERT_EQ(entry.second, it.value());
+            ++it;
+        }
+        ASSERT_TRUE(it == map.end());
+
+        map.clear();
+        ASSERT_TRUE(map.empty());
+        ASSERT_EQ(size_t(0), map.size());
+    }
+}
+
+TEST(flat_map_throwing_copy) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+        std::map<int, int> gt;
+        FlatMap<Fragile, int> map;
+        for(size_t i = 0; i < sz; i++) {
+            int key = t.range<int>(0, 128);
+            int value = t.get<int>();
+            gt.insert({key, value});
+            map.insert_unsorted(Fragile(key), value);
+        }
+
+        // A copy failing halfway through the merge loses nothing
+        Fragile::budget = t.range<int>(0, static_cast<int>(gt.size()));
+        try {
+            map.size();
+        }
+        catch(const std::runtime_error &) {}
+        Fragile::budget = -1;
+
+        ASSERT_EQ(gt.size(), map.size());
+        auto it = map.begin();
+        for(const auto & entry : gt) {
+            ASSERT_EQ(entry.first, it->first.key);
+            ASSERT_EQ(entry.second, it->second);
+            ++it;
+        }
+    }
+}
+
+TEST(flat_set) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        std::set<int> gt;
+        FlatSet<int> set;
+        std::vector<int> batch;
+        for(size_t i = 0; i < sz; i++) {
+            int key = t.range<int>(0, 512);
+            switch(t.range<int>(0, 4)) {
+                case 0:
+                    ASSERT_EQ(gt.insert(key).second, set.insert(key).second);
+                    break;
+                case 1:
+                    ASSERT_EQ(gt.erase(key), set.erase(key));
+                    break;
+                case 2:
+                    gt.insert(key);
+                    set.insert_unsorted(key);
+                    break;
+                default:
+                    batch.push_back(key);
+            }
+        }
+        gt.insert(batch.begin(), batch.end());
+        set.insert(batch.begin(), batch.end());
+
+        ASSERT_EQ(gt.size(), set.size());
+        ASSERT_TRUE(std::equal(gt.begin(), gt.end(), set.begin(), set.end()));
+        for(int key = -1; key <= 512; key++) {
+            ASSERT_EQ(gt.count(key), set.count(key));
+            ASSERT_EQ(std::distance(gt.begin(), gt.lower_bound(key)), set.lower_bound(key) - set.begin());
+            ASSERT_EQ(std::distance(gt.begin(), gt.upper_bound(key)), set.upper_bound(key) - set.begin());
+            if(!gt.count(key))
+                ASSERT_TRUE(set.find(key) == set.end());
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include "executable.h"
+#include "MappedVector.h"
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// A unique scratch file which is removed when the test ends
+struct TempPath {
+    std::string path;
+
+    TempPath() {
+        char name[] = "/tmp/mapped_vector_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        unlink(name);
+        path = name;
+    }
+    ~TempPath() { unlink(path.c_str()); }
+};
+
+struct Record {
+    int id;
+    double weight;
+};
+
+// A read-only vector only hands out const access
+static_assert(std::is_same<decltype(std::declval<MappedVector<const Record>&>()[0]), const Record &>::value, "");
+static_assert(std::is_same<decltype(*std::declval<MappedVector<const Record>&>().begin()), const Record &>::value, "");
+
+TEST(mapped_vector_persists) {
+    Typegen t;
+
+    for(size_t k = 0; k < 20; k++) {
+        TempPath tmp;
+        size_t n = t.range<size_t>(0x3FFF);
+        std::vector<int> gt(n);
+        t.fill(gt.begin(), gt.end());
+
+        {
+            MappedVector<Record> vec(tmp.path);
+            ASSERT_EQ(0UL, vec.size());
+
+            Memhook mh;
+            for(size_t i = 0; i < n; i++)
+                vec.push_back(Record{gt[i], 0.5 * i});
+            mh.disable();
+            ASSERT_EQ_(0UL, mh.n_allocs(), "Storage should come from the mapping, not the heap");
+        }
+
+        // Reopening maps the same elements back in
+        {
+            MappedVector<const Record> vec(tmp.path);
+            ASSERT_EQ(n, vec.size());
+            ASSERT_LE(n, vec.capacity());
+
+            // Plain reads work on a non-const read-only vector
+            size_t i = 0;
+            for(const Record & r : vec) {
+                ASSERT_EQ(gt[i], r.id);
+                ASSERT_EQ(0.5 * i, r.weight);
+                i++;
+            }
+            ASSERT_EQ(n, i);
+            if(n) {
+                ASSERT_EQ(gt[0], vec[0].id);
+                ASSERT_EQ(gt[0], vec.front().id);
+                ASSERT_EQ(gt[n - 1], vec.back().id);
+                ASSERT_EQ(gt[n - 1], vec.at(n - 1).id);
+            }
+            ASSERT_EXCEPTION(vec.at(n), std::out_of_range);
+        }
+
+        // A different element type is rejected
+        ASSERT_EXCEPTION(MappedVector<char>{tmp.path}, std::runtime_error);
+    }
+}
+
+TEST(mapped_vector_insert_erase) {
+    Typegen t;
+    TempPath tmp;
+
+    MappedVector<int> vec(tmp.path);
+    std::vector<int> gt;
+
+    for(size_t k = 0; k < 200; k++) {
+        int el = t.get<int>();
+        size_t at = t.range<size_t>(gt.size() + 1);
+        size_t count = t.range<size_t>(0, 20);
+        gt.insert(gt.begin() + at, count, el);
+        vec.insert(vec.begin() + at, count, el);
+
+        if(!gt.empty() && t.get<bool>(0.3)) {
+            size_t a = t.range<size_t>(gt.size());
+            size_t b = t.range<size_t>(a, gt.size() + 1);
+            gt.erase(gt.begin() + a, gt.begin() + b);
+            vec.erase(vec.begin() + a, vec.begin() + b);
+        }
+
+        // Aliased arguments survive a remap
+        if(!gt.empty()) {
+            gt.push_back(gt.front());
+            vec.emplace_back(vec.front());
+        }
+    }
+
+    ASSERT_EQ(gt.size(), vec.size());
+    for(size_t i = 0; i < gt.size(); i++)
+        ASSERT_EQ(gt[i], vec[i]);
+
+    vec.shrink_to_fit();
+    ASSERT_EQ(gt.size(), vec.capacity());
+
+    vec.clear();
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(gt.size(), vec.capacity());
+}
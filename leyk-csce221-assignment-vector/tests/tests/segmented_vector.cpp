@@ -0,0 +1,134 @@
+#include "executable.h"
+#include "SegmentedVector.h"
+#include <vector>
+#include "box.h"
+
+TEST(segmented_vector_push_back_access) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x1FFF);
+        SegmentedVector<Box<int>, 6> vec;
+        std::vector<int> gt;
+
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            gt.push_back(el);
+            if(i % 2)
+                vec.push_back(Box<int>(el));
+            else
+                vec.emplace_back(el);
+        }
+
+        ASSERT_EQ(sz, vec.size());
+        ASSERT_EQ(sz == 0, vec.empty());
+        ASSERT_EQ((sz + 63) / 64 * 64, vec.capacity());
+
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(gt[i], *vec[i]);
+        ASSERT_EXCEPTION(vec.at(sz), std::out_of_range);
+
+        size_t i = 0;
+        for(auto it = vec.begin(); it != vec.end(); it++)
+            ASSERT_EQ(gt[i++], **it);
+        ASSERT_EQ(static_cast<ptrdiff_t>(sz), vec.end() - vec.begin());
+
+        if(sz != 0) {
+            ASSERT_EQ(gt.front(), *vec.front());
+            ASSERT_EQ(gt.back(), *vec.back());
+        }
+    }
+}
+
+TEST(segmented_vector_stable_references) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0x1FFF);
+        SegmentedVector<long, 4> vec;
+        std::vector<long*> addresses;
+
+        for(size_t i = 0; i < sz; i++) {
+            vec.push_back(t.get<long>());
+            addresses.push_back(&vec.back());
+        }
+
+        // Growing never moves what is already stored
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(addresses[i], &vec[i]);
+
+        // Pushing a reference to an element is safe even across a new block
+        while(vec.size() % 16 != 0)
+            vec.push_back(vec[0]);
+        vec.push_back(vec[0]);
+        ASSERT_EQ(vec[0], vec.back());
+    }
+}
+
+TEST(segmented_vector_allocations) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFFF);
+        SegmentedVector<int, 8> vec;
+        vec.reserve(sz);
+        size_t blocks = (sz + 255) / 256;
+        ASSERT_EQ(blocks * 256, vec.capacity());
+
+        {
+            Memhook mh;
+            for(size_t i = 0; i < sz; i++)
+                vec.push_back(static_cast<int>(i));
+            mh.disable();
+            ASSERT_EQ_(0UL, mh.n_allocs(), "Reserved blocks should be reused");
+        }
+
+        // pop_back and clear keep the blocks
+        vec.pop_back();
+        vec.clear();
+        ASSERT_TRUE(vec.empty());
+        ASSERT_EQ(blocks * 256, vec.capacity());
+
+        vec.push_back(1);
+        {
+            Memhook mh;
+            vec.shrink_to_fit();
+            mh.disable();
+            ASSERT_EQ(256UL, vec.capacity());
+            // Every spare block, plus the directory when it shrinks
+            ASSERT_EQ(blocks - 1 + (blocks > 1), mh.n_frees());
+        }
+        ASSERT_EQ(1, vec[0]);
+    }
+}
+
+TEST(segmented_vector_copy_move) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        SegmentedVector<Box<int>, 5> vec;
+        for(size_t i = 0; i < sz; i++)
+            vec.push_back(t.get<int>());
+
+        SegmentedVector<Box<int>, 5> copy(vec);
+        ASSERT_EQ(sz, copy.size());
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_TRUE(vec[i] == copy[i]);
+
+        SegmentedVector<Box<int>, 5> assigned(3, Box<int>(7));
+        assigned = copy;
+        ASSERT_EQ(sz, assigned.size());
+
+        Box<int>* first = sz == 0 ? nullptr : &copy[0];
+        SegmentedVector<Box<int>, 5> moved(std::move(copy));
+        ASSERT_EQ(sz, moved.size());
+        ASSERT_TRUE(copy.empty());
+        if(sz != 0)
+            ASSERT_EQ(first, &moved[0]);
+
+        assigned = std::move(moved);
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_TRUE(vec[i] == assigned[i]);
+    }
+}
@@ -0,0 +1,169 @@
+#include "executable.h"
+#include "SharedVector.h"
+#include <thread>
+#include <vector>
+#include "box.h"
+
+TEST(shared_vector_copy_is_shallow) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFFF);
+        Vector<Box<int>> source;
+        for(size_t i = 0; i < sz; i++)
+            source.push_back(Box<int>(t.get<int>()));
+        SharedVector<Box<int>> vec(std::move(source));
+        ASSERT_EQ(1UL, vec.use_count());
+
+        {
+            Memhook mh;
+            SharedVector<Box<int>> copy(vec);
+            SharedVector<Box<int>> assigned;
+            assigned = copy;
+            mh.disable();
+            ASSERT_EQ_(0UL, mh.n_allocs(), "Copies should share the buffer");
+            ASSERT_EQ(3UL, vec.use_count());
+
+            const SharedVector<Box<int>> & view = copy;
+            ASSERT_EQ(sz, view.size());
+            for(size_t i = 0; i < sz; i++)
+                ASSERT_EQ(&view[i], &static_cast<const SharedVector<Box<int>> &>(vec)[i]);
+
+            // Iterating a const view neither detaches nor pins the buffer
+            mh.enable();
+            size_t i = 0;
+            for(const Box<int> & el : view)
+                ASSERT_EQ(&el, &view[i++]);
+            SharedVector<Box<int>> after(copy);
+            mh.disable();
+            ASSERT_EQ(sz, i);
+            ASSERT_EQ_(0UL, mh.n_allocs(), "Const iteration should keep copies shallow");
+            ASSERT_EQ(4UL, vec.use_count());
+            mh.enable();
+        }
+        ASSERT_EQ(1UL, vec.use_count());
+    }
+}
+
+TEST(shared_vector_write_detaches) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+        SharedVector<Box<int>> vec;
+        std::vector<int> gt;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            gt.push_back(el);
+            vec.push_back(Box<int>(el));
+        }
+
+        SharedVector<Box<int>> snapshot = vec;
+        const SharedVector<Box<int>> & csnap = snapshot;
+
+        size_t pos = t.range<size_t>(0, sz);
+        *vec[pos] += 1;
+        vec.push_back(Box<int>(7));
+        vec.erase(vec.begin());
+
+        // The snapshot still sees the old contents
+        ASSERT_EQ(1UL, vec.use_count());
+        ASSERT_EQ(1UL, snapshot.use_count());
+        ASSERT_EQ(sz, csnap.size());
+        size_t i = 0;
+        for(auto it = csnap.cbegin(); it != csnap.cend(); ++it)
+            ASSERT_EQ(gt[i++], **it);
+
+        ASSERT_EQ(sz, vec.size());
+        for(size_t i = 1; i < sz; i++)
+            ASSERT_EQ(gt[i] + (i == pos), *vec[i - 1]);
+        ASSERT_EQ(7, *vec.back());
+
+        // Only owner: writes do not copy
+        Box<int> * first = &vec[0];
+        vec[0] = Box<int>(3);
+        ASSERT_EQ(first, &vec[0]);
+    }
+}
+
+TEST(shared_vector_clear_and_empty) {
+    SharedVector<int> empty;
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(0UL, empty.use_count());
+    ASSERT_TRUE(empty.cbegin() == empty.cend());
+
+    SharedVector<int> vec(100, 5);
+    SharedVector<int> copy = vec;
+    {
+        Memhook mh;
+        copy.clear();
+        mh.disable();
+        ASSERT_EQ_(0UL, mh.n_allocs(), "Clearing a shared buffer should not copy it");
+    }
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(100UL, vec.size());
+    ASSERT_EQ(1UL, vec.use_count());
+    ASSERT_EXCEPTION(copy.at(0), std::out_of_range);
+}
+
+TEST(shared_vector_threads) {
+    SharedVector<long> vec;
+    for(long i = 0; i < 10000; i++)
+        vec.push_back(i);
+
+    std::vector<long> sums(8, 0);
+    std::vector<std::thread> readers;
+    for(size_t r = 0; r < sums.size(); r++)
+        readers.emplace_back([snapshot = vec, &sums, r] {
+            for(auto it = snapshot.cbegin(); it != snapshot.cend(); ++it)
+                sums[r] += *it;
+        });
+    // Writing while the readers run detaches instead of racing them
+    for(long i = 0; i < 10000; i++)
+        vec[i] = -1;
+    for(std::thread & reader : readers)
+        reader.join();
+
+    for(long sum : sums)
+        ASSERT_EQ(10000L * 9999 / 2, sum);
+    ASSERT_EQ(1UL, vec.use_count());
+}
+
+TEST(shared_vector_escaped_reference) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+        SharedVector<int> vec;
+        for(size_t i = 0; i < sz; i++)
+            vec.push_back(t.get<int>());
+
+        size_t pos = t.range<size_t>(0, sz);
+        int old = static_cast<const SharedVector<int> &>(vec)[pos];
+        int & ref = vec[pos];
+        auto it = vec.begin();
+
+        // Copies taken after a mutable reference escaped must not see writes through it
+        SharedVector<int> snapshot = vec;
+        SharedVector<int> assigned;
+        assigned = vec;
+        ref = old + 1;
+        *it = 5;
+        const SharedVector<int> & csnap = snapshot;
+        const SharedVector<int> & cassigned = assigned;
+        ASSERT_EQ(old, csnap[pos]);
+        ASSERT_EQ(old, cassigned[pos]);
+        ASSERT_EQ(1UL, vec.use_count());
+        ASSERT_EQ(1UL, snapshot.use_count());
+
+        // Copies of the snapshot, which handed out nothing, still share
+        SharedVector<int> shared = snapshot;
+        ASSERT_EQ(2UL, snapshot.use_count());
+
+        // clear() invalidates the escaped references, so sharing resumes
+        vec.clear();
+        vec.push_back(1);
+        SharedVector<int> after = vec;
+        ASSERT_EQ(2UL, vec.use_count());
+    }
+}
@@ -0,0 +1,188 @@
+#include "executable.h"
+#include "SmallVector.h"
+#include <vector>
+#include "box.h"
+
+TEST(small_vector_inline) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        int values[8];
+        t.fill(values, values + 8);
+
+        Memhook mh;
+        {
+            SmallVector<int, 8> vec;
+            bool small = true;
+            for(size_t i = 0; i < 8; i++) {
+                vec.push_back(values[i]);
+                small = small && vec.small();
+            }
+
+            mh.disable();
+            ASSERT_TRUE(small);
+            ASSERT_EQ(8UL, vec.size());
+            ASSERT_EQ(8UL, vec.capacity());
+            ASSERT_EQ_(0UL, mh.n_allocs(), "Short sequences should stay in the inline buffer");
+
+            size_t i = 0;
+            for(auto it = vec.begin(); it != vec.end(); it++)
+                ASSERT_EQ(values[i++], *it);
+
+            // The ninth element spills to the heap
+            mh.enable();
+            vec.push_back(t.get<int>());
+            mh.disable();
+            ASSERT_FALSE(vec.small());
+            ASSERT_EQ(1UL, mh.n_allocs());
+            ASSERT_EQ(16UL, vec.capacity());
+            ASSERT_EQ(16 * sizeof(int), mh.last_alloc().size);
+
+            for(size_t i = 0; i < 8; i++)
+                ASSERT_EQ(values[i], vec[i]);
+            mh.enable();
+        }
+        ASSERT_EQ(1UL, mh.n_frees());
+    }
+}
+
+TEST(small_vector_insert_erase) {
+    Typegen t;
+
+    for(size_t k = 0; k < 200; k++) {
+        size_t sz = t.range<size_t>(0, 12);
+        SmallVector<Box<int>, 4> vec;
+        std::vector<Box<int>> gt;
+
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            gt.push_back(el);
+            vec.push_back(Box<int>(el));
+        }
+
+        ptrdiff_t i = t.range<ptrdiff_t>(0, sz + 1);
+        size_t count = t.range<size_t>(0, 10);
+        int el = t.get<int>();
+
+        gt.insert(gt.begin() + i, count, el);
+        auto pos = vec.insert(vec.begin() + i, count, Box<int>(el));
+        ASSERT_EQ(i, static_cast<ptrdiff_t>(pos - vec.begin()));
+
+        i = t.range<ptrdiff_t>(0, gt.size() + 1);
+        el = t.get<int>();
+        gt.insert(gt.begin() + i, el);
+        pos = vec.insert(vec.begin() + i, Box<int>(el));
+        ASSERT_EQ(i, static_cast<ptrdiff_t>(pos - vec.begin()));
+
+        ptrdiff_t a = t.range<ptrdiff_t>(0, gt.size());
+        ptrdiff_t b = t.range<ptrdiff_t>(a, gt.size() + 1);
+        gt.erase(gt.begin() + a, gt.begin() + b);
+        vec.erase(vec.begin() + a, vec.begin() + b);
+
+        if(!gt.empty()) {
+            a = t.range<ptrdiff_t>(0, gt.size());
+            gt.erase(gt.begin() + a);
+            vec.erase(vec.begin() + a);
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t j = 0; j < gt.size(); j++)
+            ASSERT_EQ(*gt[j], *vec[j]);
+    }
+}
+
+TEST(small_vector_aliased_insert) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        // Full inline buffers, so every insert below spills to the heap
+        SmallVector<Box<int>, 4> boxes;
+        SmallVector<int, 4> ints;
+        std::vector<int> gt;
+        for(size_t i = 0; i < 4; i++) {
+            gt.push_back(t.get<int>());
+            boxes.push_back(Box<int>(gt.back()));
+            ints.push_back(gt.back());
+        }
+
+        size_t from = t.range<size_t>(0, 4);
+        size_t at = t.range<size_t>(0, 5);
+        size_t count = t.range<size_t>(1, 4);
+        std::vector<int> gt_push = gt, gt_insert = gt, gt_fill = gt, gt_move = gt;
+        gt_push.push_back(gt[from]);
+        gt_insert.insert(gt_insert.begin() + at, gt[from]);
+        gt_fill.insert(gt_fill.begin() + at, count, gt[from]);
+        gt_move.insert(gt_move.begin() + at, gt[from]);
+
+        SmallVector<Box<int>, 4> push = boxes, insert = boxes, fill = boxes, move = boxes;
+        push.push_back(push[from]);
+        insert.insert(insert.begin() + at, insert[from]);
+        fill.insert(fill.begin() + at, count, fill[from]);
+        move.insert(move.begin() + at, std::move(move[from]));
+        ASSERT_FALSE(push.small());
+
+        SmallVector<int, 4> ipush = ints, iinsert = ints, ifill = ints;
+        ipush.push_back(ipush[from]);
+        iinsert.insert(iinsert.begin() + at, iinsert[from]);
+        ifill.insert(ifill.begin() + at, count, ifill[from]);
+
+        ASSERT_EQ(gt_push.size(), push.size());
+        ASSERT_EQ(gt_insert.size(), insert.size());
+        ASSERT_EQ(gt_fill.size(), fill.size());
+        ASSERT_EQ(gt_move.size(), move.size());
+        for(size_t i = 0; i < gt_push.size(); i++) {
+            ASSERT_EQ(gt_push[i], *push[i]);
+            ASSERT_EQ(gt_push[i], ipush[i]);
+        }
+        for(size_t i = 0; i < gt_insert.size(); i++) {
+            ASSERT_EQ(gt_insert[i], *insert[i]);
+            ASSERT_EQ(gt_insert[i], iinsert[i]);
+        }
+        for(size_t i = 0; i < gt_fill.size(); i++) {
+            ASSERT_EQ(gt_fill[i], *fill[i]);
+            ASSERT_EQ(gt_fill[i], ifill[i]);
+        }
+        // Only the moved-from source is unspecified
+        size_t moved_from = at <= from ? from + 1 : from;
+        for(size_t i = 0; i < gt_move.size(); i++)
+            if(i != moved_from)
+                ASSERT_EQ(gt_move[i], *move[i]);
+    }
+}
+
+TEST(small_vector_copy_and_move) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0, 16);
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        SmallVector<Box<int>, 8> original;
+        for(size_t i = 0; i < sz; i++)
+            original.push_back(Box<int>(gt[i]));
+
+        SmallVector<Box<int>, 8> copy = original;
+        ASSERT_EQ(sz, copy.size());
+        ASSERT_EQ(sz <= 8, copy.small());
+
+        SmallVector<Box<int>, 8> moved;
+        moved.push_back(Box<int>(t.get<int>()));
+        {
+            Memhook mh;
+            moved = std::move(copy);
+            mh.disable();
+            // Spilled buffers are stolen, inline elements are moved
+            ASSERT_EQ(0UL, mh.n_allocs());
+        }
+
+        ASSERT_EQ(0UL, copy.size());
+        ASSERT_TRUE(copy.small());
+        ASSERT_EQ(sz, moved.size());
+
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_EQ(gt[i], *original[i]);
+            ASSERT_EQ(gt[i], *moved[i]);
+        }
+    }
+}
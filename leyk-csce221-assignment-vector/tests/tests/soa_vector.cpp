@@ -0,0 +1,147 @@
+#include "executable.h"
+#include "SoAVector.h"
+#include "simd.h"
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST(soa_vector_push_back_access) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        SoAVector<int, double, std::string> vec;
+        std::vector<std::tuple<int, double, std::string>> gt;
+
+        for(size_t i = 0; i < sz; i++) {
+            int a = t.get<int>();
+            double b = t.range<double>(-1e3, 1e3);
+            std::string c(t.range<size_t>(0, 40), 'x');
+            gt.emplace_back(a, b, c);
+            vec.push_back(a, b, c);
+        }
+
+        ASSERT_EQ(sz, vec.size());
+        ASSERT_EQ(sz == 0, vec.empty());
+
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_EQ(std::get<0>(gt[i]), std::get<0>(vec[i]));
+            ASSERT_EQ(std::get<1>(gt[i]), vec.get<1>(i));
+            ASSERT_TRUE(std::get<2>(gt[i]) == std::get<2>(vec.at(i)));
+        }
+        ASSERT_EXCEPTION(vec.at(sz), std::out_of_range);
+
+        // References write through to the columns
+        for(auto it = vec.begin(); it != vec.end(); ++it)
+            std::get<0>(*it) += 1;
+        size_t i = 0;
+        for(auto [a, b, c] : vec) {
+            ASSERT_EQ(std::get<0>(gt[i]) + 1, a);
+            ASSERT_EQ(std::get<1>(gt[i]), b);
+            i++;
+        }
+        ASSERT_EQ(sz, i);
+    }
+}
+
+TEST(soa_vector_insert_erase) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0x1FF);
+        SoAVector<long, std::string> vec;
+        std::vector<std::pair<long, std::string>> gt;
+
+        for(size_t i = 0; i < sz; i++) {
+            long a = t.get<long>();
+            std::string b = std::to_string(a);
+            size_t pos = t.range<size_t>(0, gt.size() + 1);
+            gt.insert(gt.begin() + pos, {a, b});
+            auto it = vec.insert(vec.begin() + pos, a, b);
+            ASSERT_EQ(pos, it.index());
+        }
+
+        size_t first = t.range<size_t>(0, gt.size() + 1);
+        size_t last = t.range<size_t>(first, gt.size() + 1);
+        gt.erase(gt.begin() + first, gt.begin() + last);
+        vec.erase(vec.begin() + first, vec.begin() + last);
+
+        if(!gt.empty()) {
+            size_t pos = t.range<size_t>(0, gt.size());
+            gt.erase(gt.begin() + pos);
+            vec.erase(vec.begin() + pos);
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++) {
+            ASSERT_EQ(gt[i].first, vec.get<0>(i));
+            ASSERT_TRUE(gt[i].second == vec.get<1>(i));
+        }
+
+        if(!gt.empty()) {
+            vec.pop_back();
+            ASSERT_EQ(gt.size() - 1, vec.size());
+        }
+        size_t cap = vec.capacity();
+        vec.clear();
+        ASSERT_TRUE(vec.empty());
+        ASSERT_EQ(cap, vec.capacity());
+    }
+}
+
+TEST(soa_vector_columns) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FF);
+        SoAVector<char, int, double> vec;
+        vec.reserve(sz);
+        ASSERT_LE(sz, vec.capacity());
+
+        int sum = 0;
+        for(size_t i = 0; i < sz; i++) {
+            int v = t.range<int>(-1000, 1000);
+            sum += v;
+            vec.push_back('a', v, v * 0.5);
+        }
+
+        Column<int> ints = vec.column<1>();
+        ASSERT_EQ(sz, ints.size());
+        ASSERT_EQ(sz == 0, ints.empty());
+        ASSERT_EQ(sum, simd::accumulate(ints.begin(), ints.end(), 0));
+
+        const SoAVector<char, int, double>& cvec = vec;
+        Column<const double> reals = cvec.column<2>();
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_EQ(vec.get<1>(i), ints[i]);
+            ASSERT_EQ(ints[i] * 0.5, reals[i]);
+        }
+
+        // Writes through a column show up in the records
+        for(int & x : ints)
+            x = 7;
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(7, std::get<1>(cvec[i]));
+    }
+}
+
+TEST(soa_vector_rollback) {
+    struct Throws {
+        Throws() = default;
+        Throws(const Throws &) { throw std::runtime_error("copy"); }
+        Throws(Throws &&) = default;
+        Throws & operator=(const Throws &) = default;
+    };
+
+    SoAVector<int, std::string, Throws> vec;
+    vec.push_back(1, std::string("one"), Throws());
+    Throws bad;
+    ASSERT_EXCEPTION(vec.push_back(2, std::string("two"), bad), std::runtime_error);
+
+    // The columns inserted before the failure were rolled back
+    ASSERT_EQ(1UL, vec.size());
+    ASSERT_EQ(1UL, vec.column<0>().size());
+    ASSERT_EQ(1UL, vec.column<1>().size());
+    ASSERT_EQ(1UL, vec.column<2>().size());
+    ASSERT_EQ(1, vec.get<0>(0));
+}
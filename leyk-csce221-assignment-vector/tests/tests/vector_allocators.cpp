@@ -0,0 +1,219 @@
+#include "executable.h"
+#include "Allocators.h"
+#include <thread>
+#include <vector>
+#include "box.h"
+
+static_assert(is_vector_iterator<Vector<int>::iterator>::value, "");
+static_assert(is_vector_iterator<Vector<int, ArenaAllocator<int>>::iterator>::value, "");
+static_assert(is_vector_iterator<Vector<int, RecyclingAllocator<int>>::iterator>::value, "");
+static_assert(!is_vector_iterator<std::vector<int>::iterator>::value, "");
+
+TEST(arena_allocator) {
+    Typegen t;
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t n_vectors = t.range<size_t>(1, 0xFF);
+        std::vector<std::vector<int>> gt(n_vectors);
+        for(size_t i = 0; i < n_vectors; i++) {
+            gt[i].resize(t.range<size_t>(0xFF));
+            t.fill(gt[i].begin(), gt[i].end());
+        }
+
+        Memhook mh;
+        {
+            Arena arena;
+            std::vector<Vector<int, ArenaAllocator<int>>> vecs;
+            mh.disable();
+            vecs.reserve(n_vectors);
+            mh.enable();
+
+            for(size_t i = 0; i < n_vectors; i++) {
+                vecs.emplace_back(ArenaAllocator<int>(arena));
+                for(size_t j = 0; j < gt[i].size(); j++)
+                    vecs[i].push_back(gt[i][j]);
+            }
+
+            for(size_t i = 0; i < n_vectors; i++) {
+                ASSERT_EQ(gt[i].size(), vecs[i].size());
+                for(size_t j = 0; j < gt[i].size(); j++) {
+                    ASSERT_EQ(gt[i][j], vecs[i][j]);
+                    // offset + iterator works whatever the allocator
+                    ASSERT_EQ(gt[i][j], *(static_cast<ptrdiff_t>(j) + vecs[i].begin()));
+                }
+            }
+
+            // Blocks grow geometrically, so only a handful of
+            // global allocations back every buffer
+            ASSERT_GE(static_cast<size_t>(1 + 16), mh.n_allocs());
+            ASSERT_EQ(0UL, mh.n_frees());
+        }
+        // Every block is returned when the arena goes away
+        ASSERT_EQ(mh.n_allocs(), mh.n_enabled_frees());
+    }
+}
+
+TEST(arena_allocator_move) {
+    Arena arena;
+    Arena other;
+
+    Vector<Box<int>, ArenaAllocator<Box<int>>> a{ArenaAllocator<Box<int>>(arena)};
+    for(int i = 0; i < 100; i++)
+        a.push_back(Box<int>(i));
+
+    // Moves propagate the allocator so the buffer is stolen
+    Vector<Box<int>, ArenaAllocator<Box<int>>> b{ArenaAllocator<Box<int>>(other)};
+    b = std::move(a);
+
+    ASSERT_EQ(0UL, a.size());
+    ASSERT_EQ(100UL, b.size());
+    ASSERT_TRUE(b.get_allocator() == ArenaAllocator<Box<int>>(arena));
+    for(int i = 0; i < 100; i++)
+        ASSERT_EQ(i, *b[i]);
+
+    // Copies propagate too
+    Vector<Box<int>, ArenaAllocator<Box<int>>> c{ArenaAllocator<Box<int>>(other)};
+    c = b;
+    ASSERT_TRUE(c.get_allocator() == ArenaAllocator<Box<int>>(arena));
+    for(int i = 0; i < 100; i++)
+        ASSERT_EQ(i, *c[i]);
+}
+
+TEST(pool_allocator) {
+    Typegen t;
+    Pool pool;
+
+    // Warm up the size classes used by doubling growth
+    {
+        Vector<int, PoolAllocator<int>> vec{PoolAllocator<int>(pool)};
+        for(int i = 0; i < 1024; i++)
+            vec.push_back(i);
+    }
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1024);
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        Memhook mh;
+        {
+            Vector<int, PoolAllocator<int>> vec{PoolAllocator<int>(pool)};
+            for(size_t i = 0; i < sz; i++)
+                vec.push_back(gt[i]);
+
+            for(size_t i = 0; i < sz; i++)
+                ASSERT_EQ(gt[i], vec[i]);
+        }
+
+        // Freed buffers are recycled through the free lists
+        ASSERT_EQ(0UL, mh.n_allocs());
+        ASSERT_EQ(0UL, mh.n_frees());
+    }
+}
+
+TEST(pool_allocator_large) {
+    Pool pool;
+    Memhook mh;
+    {
+        // Anything bigger than the largest class bypasses the pool
+        Vector<double, PoolAllocator<double>> vec(Pool::max_class_size, PoolAllocator<double>(pool));
+        ASSERT_EQ(1UL, mh.n_allocs());
+        ASSERT_EQ(Pool::max_class_size * sizeof(double), mh.last_alloc().size);
+    }
+    ASSERT_EQ(1UL, mh.n_frees());
+}
+
+TEST(recycling_allocator) {
+    Typegen t;
+    BufferCache & cache = BufferCache::local();
+    cache.release();
+
+    // Warm up the size classes used by doubling growth
+    {
+        Vector<int, RecyclingAllocator<int>> vec;
+        for(int i = 0; i < 4096; i++)
+            vec.push_back(i);
+    }
+    ASSERT_LT(0UL, cache.cached_bytes());
+    cache.reset_counters();
+
+    size_t grows = 0;
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(4096);
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        Memhook mh;
+        {
+            Vector<int, RecyclingAllocator<int>> vec;
+            for(size_t i = 0; i < sz; i++) {
+                if(vec.size() == vec.capacity())
+                    grows++;
+                vec.push_back(gt[i]);
+            }
+
+            mh.disable();
+            for(size_t i = 0; i < sz; i++)
+                ASSERT_EQ(gt[i], vec[i]);
+            mh.enable();
+        }
+
+        // Every buffer came out of the cache and went back into it
+        ASSERT_EQ(0UL, mh.n_allocs());
+        ASSERT_EQ(0UL, mh.n_frees());
+    }
+    ASSERT_EQ(grows, cache.hits());
+    ASSERT_EQ(0UL, cache.misses());
+
+    // Buffers freed past the per-class limit go back to the global allocator
+    {
+        std::vector<Vector<int, RecyclingAllocator<int>>> many(BufferCache::max_per_class + 3);
+        for(auto & vec : many)
+            vec.reserve(100000);
+        cache.release();
+        ASSERT_EQ(0UL, cache.cached_bytes());
+
+        Memhook mh;
+        many.clear();
+        ASSERT_EQ(3UL, mh.n_frees());
+        ASSERT_EQ(BufferCache::max_per_class * 131072 * sizeof(int), cache.cached_bytes());
+    }
+    cache.release();
+}
+
+namespace {
+    bool cache_alive_in_thread = false;
+    bool cache_alive_at_exit = true;
+    bool vector_freed_at_exit = false;
+
+    // Built before the thread's cache, so destroyed after it
+    struct LateFree {
+        Vector<int, RecyclingAllocator<int>> vec;
+        ~LateFree() {
+            cache_alive_at_exit = BufferCache::alive();
+            vec = Vector<int, RecyclingAllocator<int>>();
+            vector_freed_at_exit = true;
+        }
+    };
+}
+
+TEST(recycling_allocator_edges) {
+    BufferCache & cache = BufferCache::local();
+
+    // Sizes past the largest class never reach the size class search,
+    // which could not find a class for them
+    cache.deallocate(nullptr, static_cast<size_t>(-1));
+
+    // Frees after the thread's cache is gone bypass it
+    std::thread worker([] {
+        static thread_local LateFree late;
+        cache_alive_in_thread = BufferCache::alive();
+        for(int i = 0; i < 1000; i++)
+            late.vec.push_back(i);
+    });
+    worker.join();
+    ASSERT_TRUE(cache_alive_in_thread);
+    ASSERT_FALSE(cache_alive_at_exit);
+    ASSERT_TRUE(vector_freed_at_exit);
+    ASSERT_TRUE(BufferCache::alive());
+}
@@ -18,4 +18,28 @@ TEST(clear) {
         ASSERT_EQ(0UL, v.size());
         ASSERT_EQ(sz,  v.capacity());
     }
-}
\ No newline at end of file
+}
+
+TEST(clear_keeps_buffer) {
+    Typegen t;
+
+    Vector<int> v;
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+
+        // Only the first cycle has to allocate
+        Memhook mh;
+        v.reserve(0xFF);
+
+        for(size_t i = 0; i < sz; i++)
+            v.push_back(t.get<int>());
+
+        v.clear();
+
+        mh.disable();
+        ASSERT_EQ(0UL, v.size());
+        ASSERT_EQ(0xFFUL, v.capacity());
+        ASSERT_EQ(static_cast<size_t>(k == 0), mh.n_allocs());
+        ASSERT_EQ(0UL, mh.n_frees());
+    }
+}
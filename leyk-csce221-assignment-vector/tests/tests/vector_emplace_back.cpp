@@ -0,0 +1,68 @@
+#include "pushback_common.h"
+#include "executable.h"
+#include <string>
+#include <vector>
+#include "box.h"
+
+TEST(emplace_back) {
+    Typegen t;
+
+    for(int i = 0; i < 100; i++) {
+        std::vector<int> gt(last_idx, 0);
+        t.fill(gt.begin(), gt.end());
+
+        {
+            Memhook m;
+
+            Vector<Box<int>> vec;
+            for(size_t p = 0, idx = 0; p < last_idx;) {
+                const Memstate & s = state[idx];
+                // One allocation for the element built in place
+                const size_t expected_allocs = s.n_allocs + p;
+
+                m.disable();
+                ASSERT_EQ(p,           vec.size());
+                ASSERT_EQ(s.capacity,  vec.capacity());
+                ASSERT_EQ_(expected_allocs, m.n_allocs(), "The element should be constructed in place");
+                ASSERT_EQ(s.n_frees,   m.n_frees());
+                m.enable();
+
+                Box<int> & el = vec.emplace_back(gt[p]);
+
+                m.disable();
+                ASSERT_EQ(gt[p], *el);
+                m.enable();
+
+                if(state[idx + 1].idx <= ++p)
+                    idx++;
+            }
+        }
+    }
+}
+
+TEST(emplace_back_aliased) {
+    Typegen t;
+
+    for(int i = 0; i < 100; i++) {
+        Vector<std::string> vec;
+        std::vector<std::string> gt;
+
+        size_t sz = t.range<size_t>(1, 0xFF);
+        for(size_t j = 0; j < sz; j++) {
+            std::string s(t.range<size_t>(1, 40), t.get<char>());
+            gt.push_back(s);
+            vec.emplace_back(s);
+        }
+
+        // Appending an element of the vector itself must survive growth
+        for(size_t j = 0; j < sz; j++) {
+            size_t from = t.range<size_t>(gt.size());
+            gt.push_back(gt[from]);
+            vec.emplace_back(vec[from]);
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t j = 0; j < gt.size(); j++)
+            ASSERT_TRUE(gt[j] == vec[j]);
+    }
+}
@@ -0,0 +1,100 @@
+#include "executable.h"
+#include <algorithm>
+#include <vector>
+#include "box.h"
+
+TEST(erase_if) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFFF);
+        Vector<Box<int>> vec;
+        std::vector<int> gt;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.range<int>(0, 100);
+            gt.push_back(el);
+            vec.push_back(Box<int>(el));
+        }
+
+        int cutoff = t.range<int>(0, 101);
+        size_t calls = 0;
+        size_t init_cap = vec.capacity();
+        size_t removed;
+        {
+            Memhook mh;
+            removed = vec.erase_if([&](const Box<int> & b) { calls++; return *b < cutoff; });
+            mh.disable();
+            ASSERT_EQ_(0UL, mh.n_allocs(), "erase_if should compact in place");
+            ASSERT_EQ(removed, mh.n_frees());
+        }
+        gt.erase(std::remove_if(gt.begin(), gt.end(), [&](int x) { return x < cutoff; }), gt.end());
+
+        ASSERT_EQ(sz, calls);
+        ASSERT_EQ(sz - gt.size(), removed);
+        ASSERT_EQ(gt.size(), vec.size());
+        ASSERT_EQ(init_cap, vec.capacity());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], *vec[i]);
+    }
+}
+
+TEST(retain) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFFF);
+        Vector<long> vec;
+        std::vector<long> gt;
+        for(size_t i = 0; i < sz; i++) {
+            long el = t.get<long>();
+            gt.push_back(el);
+            vec.push_back(el);
+        }
+
+        size_t removed = vec.retain([](long x) { return x % 3 == 0; });
+        gt.erase(std::remove_if(gt.begin(), gt.end(), [](long x) { return x % 3 != 0; }), gt.end());
+
+        ASSERT_EQ(sz - gt.size(), removed);
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], vec[i]);
+    }
+}
+
+TEST(remove_indices) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFFF);
+        Vector<Box<int>> vec;
+        std::vector<int> values;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            values.push_back(el);
+            vec.push_back(Box<int>(el));
+        }
+
+        // Sorted, possibly repeated, some past the end
+        std::vector<size_t> indices;
+        size_t n = t.range<size_t>(0, sz + 2);
+        for(size_t i = 0; i < n; i++)
+            indices.push_back(t.range<size_t>(0, sz + 4));
+        std::sort(indices.begin(), indices.end());
+
+        std::vector<bool> drop(sz, false);
+        for(size_t idx : indices)
+            if(idx < sz)
+                drop[idx] = true;
+        std::vector<int> gt;
+        for(size_t i = 0; i < sz; i++)
+            if(!drop[i])
+                gt.push_back(values[i]);
+
+        size_t removed = vec.remove_indices(indices.begin(), indices.end());
+
+        ASSERT_EQ(sz - gt.size(), removed);
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], *vec[i]);
+    }
+}
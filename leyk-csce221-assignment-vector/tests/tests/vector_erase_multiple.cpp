@@ -1,4 +1,5 @@
 #include "executable.h"
+#include <string>
 #include <vector>
 #include "box.h"
 
@@ -39,3 +40,26 @@ TEST(erase_multiple) {
             ASSERT_TRUE(gt[i] == vec[i]);
     }
 }
+
+TEST(erase_multiple_empty_range) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+
+        Vector<std::string> vec;
+        std::vector<std::string> gt;
+        for(size_t i = 0; i < sz; i++) {
+            gt.push_back(std::string(t.range<size_t>(0, 40), 'a' + i % 26));
+            vec.push_back(gt.back());
+        }
+
+        size_t i = t.range<size_t>(0, sz + 1);
+        auto pos = vec.erase(vec.begin() + i, vec.begin() + i);
+
+        ASSERT_EQ(i, static_cast<size_t>(pos - vec.begin()));
+        ASSERT_EQ(sz, vec.size());
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_TRUE(gt[i] == vec[i]);
+    }
+}
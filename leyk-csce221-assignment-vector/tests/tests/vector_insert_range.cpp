@@ -0,0 +1,161 @@
+#include "executable.h"
+#include <list>
+#include <sstream>
+#include <iterator>
+#include <vector>
+#include "box.h"
+
+TEST(insert_range) {
+    Typegen t;
+
+    for(int k = 0; k < 200; k++) {
+        size_t sz = t.range<size_t>(0, 0xFF);
+        size_t count = t.range<size_t>(0, 0xFF);
+
+        Vector<Box<int>> vec;
+        std::vector<Box<int>> gt;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            vec.push_back(Box<int>(el));
+            gt.push_back(Box<int>(el));
+        }
+        std::list<Box<int>> source;
+        for(size_t i = 0; i < count; i++)
+            source.push_back(Box<int>(t.get<int>()));
+
+        size_t i = t.range<size_t>(0, sz + 1);
+        gt.insert(gt.begin() + i, source.begin(), source.end());
+
+        size_t init_cap = vec.capacity();
+        {
+            Memhook mh;
+            auto pos = vec.insert(vec.begin() + i, source.begin(), source.end());
+            mh.disable();
+
+            // One allocation per copied Box, plus at most one for the buffer
+            ASSERT_EQ(count + (sz + count > init_cap), mh.n_allocs());
+            ASSERT_EQ(i, static_cast<size_t>(pos - vec.begin()));
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_TRUE(*gt[i] == *vec[i]);
+    }
+}
+
+TEST(insert_range_trivial) {
+    Typegen t;
+
+    for(int k = 0; k < 200; k++) {
+        size_t sz = t.range<size_t>(0, 0xFFF);
+        size_t count = t.range<size_t>(0, 0xFFF);
+
+        Vector<int> vec;
+        std::vector<int> gt;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            vec.push_back(el);
+            gt.push_back(el);
+        }
+        // Some slack, so both the in place and the reallocating paths run
+        if(t.range<int>(0, 2))
+            vec.reserve(sz + count);
+
+        std::vector<int> source(count);
+        t.fill(source.begin(), source.end());
+
+        size_t i = t.range<size_t>(0, sz + 1);
+        gt.insert(gt.begin() + i, source.begin(), source.end());
+        vec.insert(vec.begin() + i, source.data(), source.data() + count);
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], vec[i]);
+    }
+}
+
+TEST(insert_range_input_iterator) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0, 0xFF);
+        size_t count = t.range<size_t>(0, 0xFF);
+
+        Vector<int> vec;
+        std::vector<int> gt;
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            vec.push_back(el);
+            gt.push_back(el);
+        }
+
+        std::vector<int> source(count);
+        t.fill(source.begin(), source.end());
+        std::stringstream ss;
+        for(int x : source)
+            ss << x << ' ';
+
+        size_t i = t.range<size_t>(0, sz + 1);
+        gt.insert(gt.begin() + i, source.begin(), source.end());
+        vec.insert(vec.begin() + i, std::istream_iterator<int>(ss), std::istream_iterator<int>());
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], vec[i]);
+    }
+}
+
+TEST(append_range) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        Vector<long> vec;
+        std::vector<long> gt;
+        size_t batches = t.range<size_t>(1, 10);
+        for(size_t b = 0; b < batches; b++) {
+            std::vector<long> batch(t.range<size_t>(0, 0x3FF));
+            t.fill(batch.begin(), batch.end());
+            gt.insert(gt.end(), batch.begin(), batch.end());
+
+            size_t expected_cap = vec.capacity();
+            if(vec.size() + batch.size() > expected_cap)
+                expected_cap = std::max(vec.size() + batch.size(), 2 * expected_cap);
+
+            vec.append_range(batch);
+            ASSERT_EQ(expected_cap, vec.capacity());
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], vec[i]);
+    }
+}
+
+TEST(assign_range) {
+    Typegen t;
+
+    for(int k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0, 0xFF);
+        size_t count = t.range<size_t>(0, 0xFF);
+
+        Vector<Box<int>> vec;
+        for(size_t i = 0; i < sz; i++)
+            vec.push_back(Box<int>(t.get<int>()));
+        std::vector<Box<int>> source;
+        for(size_t i = 0; i < count; i++)
+            source.push_back(Box<int>(t.get<int>()));
+
+        size_t init_cap = vec.capacity();
+        {
+            Memhook mh;
+            vec.assign(source.begin(), source.end());
+            mh.disable();
+            ASSERT_EQ(count + (count > init_cap), mh.n_allocs());
+        }
+
+        ASSERT_EQ(count > init_cap ? count : init_cap, vec.capacity());
+        ASSERT_EQ(count, vec.size());
+        for(size_t i = 0; i < count; i++)
+            ASSERT_TRUE(*source[i] == *vec[i]);
+    }
+}
@@ -0,0 +1,75 @@
+#include "executable.h"
+#include "MmapAllocator.h"
+#include <vector>
+
+TEST(mmap_allocator_growth) {
+    Typegen t;
+
+    // A tiny threshold so the mapped path is exercised with small vectors
+    const size_t threshold = 4096;
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t n = t.range<size_t>(0x1000, 0x10000);
+        std::vector<long> gt(n);
+        t.fill(gt.begin(), gt.end());
+
+        Memhook mh;
+        {
+            Vector<long, MmapAllocator<long>> vec{MmapAllocator<long>(threshold, k & 1)};
+            for(size_t i = 0; i < n; i++)
+                vec.push_back(gt[i]);
+
+            mh.disable();
+            ASSERT_EQ(n, vec.size());
+            for(size_t i = 0; i < n; i++)
+                ASSERT_EQ(gt[i], vec[i]);
+
+            // Only the buffers below the threshold hit the global allocator
+            size_t small_buffers = 0;
+            for(size_t cap = 1; cap * sizeof(long) < threshold; cap *= 2)
+                small_buffers++;
+            ASSERT_EQ(small_buffers, mh.n_allocs());
+            ASSERT_EQ(small_buffers, mh.n_frees());
+            mh.enable();
+
+            // Shrinking back below the threshold copies out of the mapping
+            vec.resize(10);
+            vec.shrink_to_fit();
+
+            mh.disable();
+            ASSERT_EQ(10UL, vec.capacity());
+            for(size_t i = 0; i < 10; i++)
+                ASSERT_EQ(gt[i], vec[i]);
+            mh.enable();
+        }
+        ASSERT_EQ(mh.n_allocs(), mh.n_frees());
+    }
+}
+
+TEST(mmap_allocator_reserve_and_copy) {
+    Typegen t;
+    const size_t threshold = 4096;
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t n = t.range<size_t>(1, 0x4000);
+
+        Vector<int, MmapAllocator<int>> vec{MmapAllocator<int>(threshold)};
+        vec.reserve(t.range<size_t>(n));
+        for(size_t i = 0; i < n; i++)
+            vec.emplace_back(static_cast<int>(i));
+
+        // Aliased arguments survive an in-place resize
+        vec.emplace_back(vec[0]);
+
+        Vector<int, MmapAllocator<int>> copy = vec;
+        vec.insert(vec.begin(), 1000, -1);
+
+        ASSERT_EQ(n + 1, copy.size());
+        ASSERT_EQ(n + 1001, vec.size());
+        for(size_t i = 0; i < n; i++) {
+            ASSERT_EQ(static_cast<int>(i), copy[i]);
+            ASSERT_EQ(static_cast<int>(i), vec[i + 1000]);
+        }
+        ASSERT_EQ(0, copy[n]);
+    }
+}
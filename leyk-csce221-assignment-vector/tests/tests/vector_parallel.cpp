@@ -0,0 +1,161 @@
+#include "executable.h"
+#include "parallel.h"
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(parallel_for_each_transform) {
+    Typegen t;
+    parallel::ThreadPool pool(4);
+
+    for(size_t k = 0; k < 50; k++) {
+        size_t sz = t.range<size_t>(0x3FFFF);
+        size_t grain = t.range<size_t>(1, 0x3FFF);
+
+        Vector<long> vec(sz);
+        std::vector<long> gt(sz);
+        for(size_t i = 0; i < sz; i++)
+            vec[i] = gt[i] = t.get<int>();
+
+        parallel::for_each(vec.begin(), vec.end(), [](long & x) { x = 3 * x + 1; }, grain, pool);
+        for(long & x : gt)
+            x = 3 * x + 1;
+
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(gt[i], vec[i]);
+
+        Vector<double> out(sz);
+        auto end = parallel::transform(vec.begin(), vec.end(), out.begin(), [](long x) { return x * 0.5; }, grain, pool);
+        ASSERT_TRUE(end == out.end());
+
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(gt[i] * 0.5, out[i]);
+    }
+}
+
+TEST(parallel_chunks_end_on_lines) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t size = t.range<size_t>(1, 200);
+        size_t grain = t.range<size_t>(1, 1000);
+        size_t n = t.range<size_t>(0, 0xFFFF);
+        parallel::Chunks chunks(n, size, grain);
+
+        size_t covered = 0;
+        for(size_t c = 0; c < chunks.count(); c++) {
+            ASSERT_EQ(covered, chunks.begin(c));
+            ASSERT_EQ(0UL, chunks.begin(c) * size % parallel::cache_line);
+            if(c + 1 < chunks.count())
+                ASSERT_LE(grain, chunks.end(c) - chunks.begin(c));
+            covered = chunks.end(c);
+        }
+        ASSERT_EQ(n, covered);
+    }
+}
+
+TEST(parallel_reduce) {
+    Typegen t;
+    parallel::ThreadPool one(1);
+    parallel::ThreadPool many(8);
+
+    for(size_t k = 0; k < 50; k++) {
+        size_t sz = t.range<size_t>(0x3FFFF);
+        size_t grain = t.range<size_t>(1, 0x3FFF);
+
+        Vector<unsigned long> ints(sz);
+        Vector<double> reals(sz);
+        for(size_t i = 0; i < sz; i++) {
+            ints[i] = t.get<unsigned long>();
+            reals[i] = t.range<double>(-1e6, 1e6);
+        }
+
+        unsigned long expected = std::accumulate(ints.begin(), ints.end(), 5UL);
+        ASSERT_EQ(expected, parallel::reduce(ints.begin(), ints.end(), 5UL, std::plus<unsigned long>(), grain, many));
+
+        // Same grain, same answer, whatever the number of threads
+        double a = parallel::reduce(reals.begin(), reals.end(), 0.0, std::plus<double>(), grain, one);
+        double b = parallel::reduce(reals.begin(), reals.end(), 0.0, std::plus<double>(), grain, many);
+        double c = parallel::reduce(reals.begin(), reals.end(), 0.0, std::plus<double>(), grain, many);
+        ASSERT_EQ(a, b);
+        ASSERT_EQ(b, c);
+    }
+}
+
+TEST(parallel_inclusive_scan) {
+    Typegen t;
+    parallel::ThreadPool pool(4);
+
+    for(size_t k = 0; k < 50; k++) {
+        size_t sz = t.range<size_t>(0x3FFFF);
+        size_t grain = t.range<size_t>(1, 0x3FFF);
+
+        Vector<long> vec(sz);
+        std::vector<long> gt(sz);
+        for(size_t i = 0; i < sz; i++)
+            vec[i] = gt[i] = t.range<int>(-1000, 1000);
+
+        std::vector<long> scanned(sz);
+        std::partial_sum(gt.begin(), gt.end(), scanned.begin());
+
+        Vector<long> out(sz);
+        parallel::inclusive_scan(vec.begin(), vec.end(), out.begin(), std::plus<long>(), grain, pool);
+
+        // In place
+        parallel::inclusive_scan(vec.begin(), vec.end(), vec.begin(), std::plus<long>(), grain, pool);
+
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_EQ(scanned[i], out[i]);
+            ASSERT_EQ(scanned[i], vec[i]);
+        }
+    }
+}
+
+TEST(parallel_nested) {
+    parallel::ThreadPool pool(4);
+    Vector<Vector<int>> rows(64, Vector<int>(1000, 1));
+
+    // Inner calls from inside a task run inline rather than deadlock
+    parallel::for_each(rows.begin(), rows.end(), [&](Vector<int> & row) {
+        parallel::for_each(row.begin(), row.end(), [](int & x) { x++; }, 16, pool);
+    }, 1, pool);
+
+    for(size_t i = 0; i < rows.size(); i++)
+        for(size_t j = 0; j < rows[i].size(); j++)
+            ASSERT_EQ(2, rows[i][j]);
+}
+
+TEST(parallel_back_to_back_batches) {
+    parallel::ThreadPool pool(8);
+
+    // Many tiny batches in a row, each with a short-lived function, so that
+    // workers regularly wake after their batch has already finished
+    for(size_t k = 0; k < 2000; k++) {
+        std::vector<size_t> hits(k % 7 + 2, 0);
+        pool.run(hits.size(), [&hits, k](size_t i) { hits[i] += k + 1; });
+        for(size_t h : hits)
+            ASSERT_EQ(k + 1, h);
+    }
+}
+
+TEST(parallel_exception) {
+    parallel::ThreadPool pool(4);
+
+    for(size_t k = 0; k < 100; k++) {
+        std::atomic<size_t> ran(0);
+        size_t bad = k % 64;
+        ASSERT_EXCEPTION(pool.run(64, [&](size_t i) {
+            ran++;
+            if(i == bad)
+                throw std::runtime_error("task failed");
+        }), std::runtime_error);
+        ASSERT_LE(ran.load(), size_t(64));
+
+        // The pool is still usable afterwards
+        std::atomic<size_t> sum(0);
+        pool.run(64, [&](size_t i) { sum += i; });
+        ASSERT_EQ(size_t(64 * 63 / 2), sum.load());
+    }
+}
@@ -0,0 +1,123 @@
+#include "executable.h"
+#include <vector>
+
+// Counts every special member call so we can check that
+// only the live elements are ever constructed
+struct Tracked {
+    static size_t n_constructs;
+    static size_t n_destructs;
+    static size_t n_assigns;
+
+    int value;
+
+    Tracked() = delete;
+    explicit Tracked(int value) : value(value) { n_constructs++; }
+    Tracked(const Tracked& other) : value(other.value) { n_constructs++; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { n_constructs++; }
+    ~Tracked() { n_destructs++; }
+    Tracked& operator=(const Tracked& other) { value = other.value; n_assigns++; return *this; }
+    Tracked& operator=(Tracked&& other) noexcept { value = other.value; n_assigns++; return *this; }
+
+    static void reset() { n_constructs = n_destructs = n_assigns = 0; }
+};
+
+size_t Tracked::n_constructs = 0;
+size_t Tracked::n_destructs = 0;
+size_t Tracked::n_assigns = 0;
+
+TEST(raw_storage_growth) {
+    Typegen t;
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t n = t.range<size_t>(1, 0xFFF);
+        std::vector<int> gt(n);
+        t.fill(gt.begin(), gt.end());
+
+        {
+            Vector<Tracked> vec;
+
+            for(size_t i = 0; i < n; i++) {
+                Tracked::reset();
+                size_t cap = vec.capacity();
+
+                vec.push_back(Tracked(gt[i]));
+
+                // The temporary plus the moved-in element, plus a
+                // move for every live element on reallocation
+                size_t wanted = 2 + (cap == i ? i : 0);
+                ASSERT_EQ_(wanted, Tracked::n_constructs, "Spare capacity should not be constructed");
+                ASSERT_EQ(0UL, Tracked::n_assigns);
+                ASSERT_EQ(Tracked::n_constructs, Tracked::n_destructs + 1);
+            }
+
+            for(size_t i = 0; i < n; i++)
+                ASSERT_EQ(gt[i], vec[i].value);
+
+            Tracked::reset();
+        }
+
+        // Only the live elements are destroyed
+        ASSERT_EQ(n, Tracked::n_destructs);
+    }
+}
+
+TEST(raw_storage_fill_constructor) {
+    Typegen t;
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t n = t.range<size_t>(0xFFF);
+        Tracked el(t.get<int>());
+
+        Tracked::reset();
+        {
+            Vector<Tracked> vec(n, el);
+
+            ASSERT_EQ(n, Tracked::n_constructs);
+            ASSERT_EQ(0UL, Tracked::n_assigns);
+
+            for(size_t i = 0; i < n; i++)
+                ASSERT_EQ(el.value, vec[i].value);
+        }
+        ASSERT_EQ(n, Tracked::n_destructs);
+    }
+}
+
+TEST(raw_storage_insert_erase) {
+    Typegen t;
+
+    for(size_t k = 0; k < 50; k++) {
+        size_t sz = t.range<size_t>(1, 0xFF);
+        std::vector<int> gt;
+        Vector<Tracked> vec;
+
+        for(size_t i = 0; i < sz; i++) {
+            gt.push_back(t.get<int>());
+            vec.push_back(Tracked(gt.back()));
+        }
+
+        size_t count = t.range<size_t>(0, 0xFF);
+        ptrdiff_t i = t.range<ptrdiff_t>(0, sz);
+        int el = t.get<int>();
+
+        gt.insert(gt.begin() + i, count, el);
+        vec.insert(vec.begin() + i, count, Tracked(el));
+
+        ptrdiff_t a = t.range<ptrdiff_t>(0, gt.size());
+        ptrdiff_t b = t.range<ptrdiff_t>(a, gt.size() + 1);
+
+        gt.erase(gt.begin() + a, gt.begin() + b);
+
+        Tracked::reset();
+        vec.erase(vec.begin() + a, vec.begin() + b);
+        ASSERT_EQ(static_cast<size_t>(b - a), Tracked::n_destructs);
+
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t j = 0; j < gt.size(); j++)
+            ASSERT_EQ(gt[j], vec[j].value);
+
+        Tracked::reset();
+        size_t live = vec.size();
+        vec.clear();
+        ASSERT_EQ(live, Tracked::n_destructs);
+    }
+}
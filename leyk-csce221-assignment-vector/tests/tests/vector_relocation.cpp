@@ -0,0 +1,112 @@
+#include "executable.h"
+#include "SmallVector.h"
+#include <vector>
+
+// Owns a heap int like Box, but opts in to bytewise relocation. Any call to
+// its move constructor or move assignment means the fast path was skipped.
+struct Handle {
+    static size_t n_moves;
+
+    int* ptr;
+
+    explicit Handle(int value) : ptr(new int(value)) {}
+    Handle(const Handle& other) : ptr(new int(*other.ptr)) {}
+    Handle(Handle&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; n_moves++; }
+    ~Handle() { delete ptr; }
+    Handle& operator=(const Handle& other) { *ptr = *other.ptr; return *this; }
+    Handle& operator=(Handle&& other) noexcept { std::swap(ptr, other.ptr); n_moves++; return *this; }
+};
+
+size_t Handle::n_moves = 0;
+
+template <>
+struct is_trivially_relocatable<Handle> : std::true_type {};
+
+struct Pod {
+    int a;
+    double b;
+    char c[3];
+};
+
+TEST(relocation_traits) {
+    ASSERT_TRUE(is_trivially_relocatable<int>::value);
+    ASSERT_TRUE(is_trivially_relocatable<Pod>::value);
+    ASSERT_TRUE(is_trivially_relocatable<double*>::value);
+    ASSERT_TRUE(is_trivially_relocatable<Handle>::value);
+    ASSERT_FALSE(is_trivially_relocatable<std::vector<int>>::value);
+}
+
+TEST(relocation_opt_in) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        Handle::n_moves = 0;
+
+        std::vector<int> gt;
+        Vector<Handle> vec;
+
+        size_t sz = t.range<size_t>(1, 0xFF);
+        for(size_t i = 0; i < sz; i++) {
+            gt.push_back(t.get<int>());
+            vec.emplace_back(gt.back());
+        }
+
+        for(size_t i = 0; i < 20; i++) {
+            int el = t.get<int>();
+            size_t at = t.range<size_t>(gt.size() + 1);
+            size_t count = t.range<size_t>(4);
+            gt.insert(gt.begin() + at, count, el);
+            vec.insert(vec.begin() + at, count, Handle(el));
+
+            if(!gt.empty()) {
+                at = t.range<size_t>(gt.size());
+                gt.erase(gt.begin() + at);
+                vec.erase(vec.begin() + at);
+            }
+
+            size_t a = t.range<size_t>(gt.size() + 1);
+            size_t b = t.range<size_t>(a, gt.size() + 1);
+            gt.erase(gt.begin() + a, gt.begin() + b);
+            vec.erase(vec.begin() + a, vec.begin() + b);
+        }
+
+        ASSERT_EQ_(0UL, Handle::n_moves, "Relocatable elements should be shifted bytewise");
+        ASSERT_EQ(gt.size(), vec.size());
+        for(size_t i = 0; i < gt.size(); i++)
+            ASSERT_EQ(gt[i], *vec[i].ptr);
+    }
+}
+
+TEST(relocation_pod) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        std::vector<int> gt;
+        Vector<Pod> vec;
+        SmallVector<Pod, 4> small;
+
+        size_t sz = t.range<size_t>(0, 0xFF);
+        for(size_t i = 0; i < sz; i++) {
+            int el = t.get<int>();
+            size_t at = t.range<size_t>(gt.size() + 1);
+            gt.insert(gt.begin() + at, el);
+            vec.insert(vec.begin() + at, Pod{el, 0.5, {'a', 'b', 'c'}});
+            small.insert(small.begin() + at, Pod{el, 0.5, {'a', 'b', 'c'}});
+        }
+
+        while(gt.size() > sz / 2) {
+            size_t at = t.range<size_t>(gt.size());
+            gt.erase(gt.begin() + at);
+            vec.erase(vec.begin() + at);
+            small.erase(small.begin() + at);
+        }
+
+        ASSERT_EQ(gt.size(), vec.size());
+        ASSERT_EQ(gt.size(), small.size());
+        for(size_t i = 0; i < gt.size(); i++) {
+            ASSERT_EQ(gt[i], vec[i].a);
+            ASSERT_EQ(gt[i], small[i].a);
+            ASSERT_EQ('c', vec[i].c[2]);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "executable.h"
+#include <vector>
+#include "box.h"
+
+TEST(reserve) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFF);
+        size_t cap = t.range<size_t>(1, 0xFFF);
+
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        Vector<Box<int>> vec;
+        for(size_t i = 0; i < sz; i++)
+            vec.push_back(Box<int>(gt[i]));
+
+        size_t init_cap = vec.capacity();
+        {
+            Memhook mh;
+
+            vec.reserve(cap);
+
+            mh.disable();
+            if(cap > init_cap) {
+                ASSERT_EQ(cap, vec.capacity());
+                ASSERT_EQ_(1UL, mh.n_allocs(), "Reserve should reallocate once and move the elements");
+                ASSERT_EQ(static_cast<size_t>(init_cap != 0), mh.n_frees());
+            } else {
+                ASSERT_EQ_(init_cap, vec.capacity(), "Reserve should never shrink");
+                ASSERT_EQ(0UL, mh.n_allocs());
+                ASSERT_EQ(0UL, mh.n_frees());
+            }
+        }
+
+        ASSERT_EQ(sz, vec.size());
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(gt[i], *vec[i]);
+
+        // Filling up to the reserved capacity never reallocates
+        size_t reserved = vec.capacity();
+        {
+            Memhook mh;
+            while(vec.size() < reserved)
+                vec.push_back(Box<int>(nullptr));
+
+            mh.disable();
+            ASSERT_EQ(0UL, mh.n_frees());
+            ASSERT_EQ(reserved, vec.capacity());
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "executable.h"
+#include <string>
+#include <vector>
+
+TEST(resize) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFF);
+        size_t count = t.range<size_t>(0x1FF);
+
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        Vector<int> vec(sz);
+        for(size_t i = 0; i < sz; i++)
+            vec[i] = gt[i];
+
+        gt.resize(count);
+
+        size_t init_cap = vec.capacity();
+        {
+            Memhook mh;
+
+            vec.resize(count);
+
+            mh.disable();
+            ASSERT_EQ(static_cast<size_t>(count > init_cap), mh.n_allocs());
+        }
+
+        ASSERT_EQ(count, vec.size());
+        ASSERT_EQ(std::max(count, init_cap), vec.capacity());
+        for(size_t i = 0; i < count; i++)
+            ASSERT_EQ_(gt[i], vec[i], "New elements should be value initialized");
+    }
+}
+
+TEST(resize_value) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFF);
+        size_t count = t.range<size_t>(0x1FF);
+        std::string value(t.range<size_t>(1, 40), 'a');
+
+        std::vector<std::string> gt(sz, "b");
+        Vector<std::string> vec(sz, "b");
+
+        gt.resize(count, value);
+        vec.resize(count, value);
+
+        ASSERT_EQ(count, vec.size());
+        for(size_t i = 0; i < count; i++)
+            ASSERT_TRUE(gt[i] == vec[i]);
+    }
+}
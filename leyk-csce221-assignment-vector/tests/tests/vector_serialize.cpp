@@ -0,0 +1,150 @@
+#include "executable.h"
+#include "serialize.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    std::string temp_path(const char * name) {
+        return "/tmp/vector_serialize_" + std::to_string(getpid()) + "_" + name;
+    }
+}
+
+TEST(serialize_trivial_roundtrip) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0x3FFF);
+        Vector<double> vec(sz);
+        for(size_t i = 0; i < sz; i++)
+            vec[i] = t.range<double>(-1e9, 1e9);
+
+        std::stringstream ss;
+        serial::save(ss, vec);
+        ASSERT_EQ(serial::header_bytes + sz * sizeof(double), ss.str().size());
+
+        Vector<double> copy = serial::load<double>(ss);
+        ASSERT_EQ(sz, copy.size());
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(vec[i], copy[i]);
+    }
+}
+
+TEST(serialize_strings_and_nested) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFF);
+        Vector<std::string> words;
+        Vector<Vector<int>> rows;
+        for(size_t i = 0; i < sz; i++) {
+            words.push_back(std::string(t.range<size_t>(0, 100), static_cast<char>(t.range<int>(0, 256))));
+            Vector<int> row(t.range<size_t>(0, 50));
+            for(size_t j = 0; j < row.size(); j++)
+                row[j] = t.get<int>();
+            rows.push_back(row);
+        }
+
+        std::stringstream ws, rs;
+        serial::save(ws, words);
+        serial::save(rs, rows);
+
+        Vector<std::string> words2 = serial::load<std::string>(ws);
+        Vector<Vector<int>> rows2 = serial::load<Vector<int>>(rs);
+
+        ASSERT_EQ(sz, words2.size());
+        ASSERT_EQ(sz, rows2.size());
+        for(size_t i = 0; i < sz; i++) {
+            ASSERT_TRUE(words[i] == words2[i]);
+            ASSERT_EQ(rows[i].size(), rows2[i].size());
+            for(size_t j = 0; j < rows[i].size(); j++)
+                ASSERT_EQ(rows[i][j], rows2[i][j]);
+        }
+    }
+}
+
+TEST(serialize_rejects_bad_input) {
+    Vector<int> vec(100, 7);
+    std::stringstream ss;
+    serial::save(ss, vec);
+    std::string bytes = ss.str();
+
+    // Wrong element type
+    {
+        std::stringstream in(bytes);
+        ASSERT_EXCEPTION(serial::load<float>(in), std::runtime_error);
+    }
+    {
+        std::stringstream in(bytes);
+        ASSERT_EXCEPTION(serial::load<unsigned>(in), std::runtime_error);
+    }
+    {
+        std::stringstream in(bytes);
+        ASSERT_EXCEPTION(serial::load<long>(in), std::runtime_error);
+    }
+    // Nested Vectors of a different width, even where the payload would
+    // line up byte for byte
+    {
+        Vector<Vector<int>> rows(5);
+        std::stringstream nested;
+        serial::save(nested, rows);
+        ASSERT_EXCEPTION(serial::load<Vector<long>>(nested), std::runtime_error);
+        std::stringstream deeper;
+        serial::save(deeper, Vector<Vector<Vector<short>>>(3));
+        ASSERT_EXCEPTION(serial::load<Vector<Vector<int>>>(deeper), std::runtime_error);
+    }
+    // Flipped payload bit
+    {
+        std::string corrupt = bytes;
+        corrupt[serial::header_bytes + 17] ^= 1;
+        std::stringstream in(corrupt);
+        ASSERT_EXCEPTION(serial::load<int>(in), std::runtime_error);
+    }
+    // Truncated payload and header
+    {
+        std::stringstream in(bytes.substr(0, bytes.size() - 3));
+        ASSERT_EXCEPTION(serial::load<int>(in), std::runtime_error);
+    }
+    {
+        std::stringstream in(bytes.substr(0, 10));
+        ASSERT_EXCEPTION(serial::load<int>(in), std::runtime_error);
+    }
+    // Not a serialized Vector at all
+    {
+        std::stringstream in(std::string(200, 'x'));
+        ASSERT_EXCEPTION(serial::load<int>(in), std::runtime_error);
+    }
+}
+
+TEST(serialize_file_and_map) {
+    Typegen t;
+    std::string path = temp_path("map");
+
+    for(size_t k = 0; k < 20; k++) {
+        size_t sz = t.range<size_t>(0xFFFF);
+        Vector<long> vec(sz);
+        for(size_t i = 0; i < sz; i++)
+            vec[i] = t.get<long>();
+
+        serial::save(path, vec);
+
+        Vector<long> loaded = serial::load<long>(path);
+        ASSERT_EQ(sz, loaded.size());
+
+        serial::View<long> view = serial::map<long>(path, true);
+        ASSERT_EQ(sz, view.size());
+        ASSERT_EQ(sz == 0, view.empty());
+        size_t i = 0;
+        for(const long * it = view.begin(); it != view.end(); ++it, ++i) {
+            ASSERT_EQ(vec[i], *it);
+            ASSERT_EQ(vec[i], loaded[i]);
+        }
+        ASSERT_EXCEPTION(view.at(sz), std::out_of_range);
+        ASSERT_EXCEPTION(serial::map<int>(path), std::runtime_error);
+    }
+    std::remove(path.c_str());
+
+    ASSERT_EXCEPTION(serial::map<long>(temp_path("missing")), std::system_error);
+}
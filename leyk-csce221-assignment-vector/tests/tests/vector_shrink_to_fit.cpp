@@ -0,0 +1,41 @@
+#include "executable.h"
+#include <vector>
+#include "box.h"
+
+TEST(shrink_to_fit) {
+    Typegen t;
+
+    for(size_t k = 0; k < 100; k++) {
+        size_t sz = t.range<size_t>(0xFF);
+        size_t cap = t.range<size_t>(sz, 0x1FF);
+
+        std::vector<int> gt(sz);
+        t.fill(gt.begin(), gt.end());
+
+        Vector<Box<int>> vec;
+        vec.reserve(cap);
+        for(size_t i = 0; i < sz; i++)
+            vec.push_back(Box<int>(gt[i]));
+
+        size_t init_cap = vec.capacity();
+        {
+            Memhook mh;
+
+            vec.shrink_to_fit();
+
+            mh.disable();
+            ASSERT_EQ(sz, vec.capacity());
+            if(sz == init_cap) {
+                ASSERT_EQ(0UL, mh.n_allocs());
+                ASSERT_EQ(0UL, mh.n_frees());
+            } else {
+                ASSERT_EQ(static_cast<size_t>(sz != 0), mh.n_allocs());
+                ASSERT_EQ(1UL, mh.n_frees());
+            }
+        }
+
+        ASSERT_EQ(sz, vec.size());
+        for(size_t i = 0; i < sz; i++)
+            ASSERT_EQ(gt[i], *vec[i]);
+    }
+}
@@ -0,0 +1,131 @@
+#include "executable.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Runs body once per instruction set up to the detected one
+#define FOR_EACH_ISA(body)                                             \
+    do {                                                               \
+        simd::isa detected = simd::detect_isa();                       \
+        for(int level = 0; level <= static_cast<int>(detected); level++) { \
+            simd::select_isa(static_cast<simd::isa>(level));           \
+            body                                                       \
+        }                                                              \
+        simd::select_isa(detected);                                    \
+    } while(0)
+
+template <typename T>
+void fill_small(Typegen & t, Vector<T> & vec, std::vector<T> & gt, size_t sz) {
+    for(size_t i = 0; i < sz; i++) {
+        // A narrow range so find and count have something to hit
+        T el = static_cast<T>(t.range<int>(-8, 8));
+        vec.push_back(el);
+        gt.push_back(el);
+    }
+}
+
+TEST(simd_select_isa_clamps) {
+    int detected = static_cast<int>(simd::detect_isa());
+
+    // Lowering sticks
+    ASSERT_EQ(0, static_cast<int>(simd::select_isa(simd::isa::scalar)));
+    ASSERT_EQ(0, static_cast<int>(simd::selected_isa()));
+
+    // Raising stops at what the CPU supports
+    ASSERT_EQ(detected, static_cast<int>(simd::select_isa(simd::isa::avx2)));
+    ASSERT_EQ(detected, static_cast<int>(simd::selected_isa()));
+}
+
+TEST(simd_find_count) {
+    Typegen t;
+
+    FOR_EACH_ISA({
+        for(size_t k = 0; k < 100; k++) {
+            size_t sz = t.range<size_t>(0x3FF);
+            int needle = t.range<int>(-10, 10);
+
+            Vector<int> vi; std::vector<int> gi;
+            fill_small(t, vi, gi, sz);
+            Vector<int8_t> vc; std::vector<int8_t> gc;
+            fill_small(t, vc, gc, sz);
+            Vector<double> vd; std::vector<double> gd;
+            fill_small(t, vd, gd, sz);
+
+            ASSERT_EQ(std::find(gi.begin(), gi.end(), needle) - gi.begin(), simd::find(vi.begin(), vi.end(), needle) - vi.begin());
+            ASSERT_EQ(std::find(gd.begin(), gd.end(), needle) - gd.begin(), simd::find(vd.begin(), vd.end(), needle) - vd.begin());
+            ASSERT_EQ(static_cast<size_t>(std::count(gi.begin(), gi.end(), needle)), simd::count(vi.begin(), vi.end(), needle));
+            ASSERT_EQ(static_cast<size_t>(std::count(gc.begin(), gc.end(), needle)), simd::count(vc.begin(), vc.end(), static_cast<int8_t>(needle)));
+            ASSERT_EQ(static_cast<size_t>(std::count(gd.begin(), gd.end(), needle)), simd::count(vd.begin(), vd.end(), needle));
+        }
+
+        // Byte lanes must not overflow on long runs of matches
+        Vector<uint8_t> ones(0x10000, 1);
+        ASSERT_EQ(0x10000UL, simd::count(ones.begin(), ones.end(), static_cast<uint8_t>(1)));
+    });
+}
+
+TEST(simd_fill_equal) {
+    Typegen t;
+
+    FOR_EACH_ISA({
+        for(size_t k = 0; k < 100; k++) {
+            size_t sz = t.range<size_t>(0x3FF);
+            float value = t.unit<float>();
+
+            Vector<float> a(sz);
+            Vector<float> b(sz);
+            simd::fill(a.begin(), a.end(), value);
+            simd::fill(b.begin(), b.end(), value);
+
+            for(size_t i = 0; i < sz; i++)
+                ASSERT_EQ(value, a[i]);
+
+            ASSERT_TRUE(simd::equal(a.begin(), a.end(), b.begin()));
+
+            if(sz) {
+                size_t at = t.range<size_t>(sz);
+                b[at] = value + 1.0f;
+                ASSERT_FALSE(simd::equal(a.begin(), a.end(), b.begin()));
+            }
+        }
+    });
+}
+
+TEST(simd_minmax_accumulate) {
+    Typegen t;
+
+    FOR_EACH_ISA({
+        for(size_t k = 0; k < 100; k++) {
+            size_t sz = t.range<size_t>(1, 0x3FF);
+
+            Vector<int> vi; std::vector<int> gi;
+            Vector<unsigned long> vu; std::vector<unsigned long> gu;
+            Vector<double> vd; std::vector<double> gd;
+            for(size_t i = 0; i < sz; i++) {
+                gi.push_back(t.get<int>()); vi.push_back(gi.back());
+                gu.push_back(t.get<unsigned long>()); vu.push_back(gu.back());
+                gd.push_back(t.range<double>(-1.0, 1.0)); vd.push_back(gd.back());
+            }
+
+            auto mi = std::minmax_element(gi.begin(), gi.end());
+            auto ri = simd::minmax(vi.begin(), vi.end());
+            ASSERT_EQ(*mi.first, ri.first);
+            ASSERT_EQ(*mi.second, ri.second);
+
+            auto md = std::minmax_element(gd.begin(), gd.end());
+            auto rd = simd::minmax(vd.begin(), vd.end());
+            ASSERT_EQ(*md.first, rd.first);
+            ASSERT_EQ(*md.second, rd.second);
+
+            // Unsigned sums wrap identically in any order
+            ASSERT_EQ(std::accumulate(gu.begin(), gu.end(), 7UL), simd::accumulate(vu.begin(), vu.end(), 7UL));
+
+            // Floating point sums are reassociated, so only close
+            double sum = std::accumulate(gd.begin(), gd.end(), 0.0);
+            ASSERT_LT(std::fabs(sum - simd::accumulate(vd.begin(), vd.end(), 0.0)), 1e-9);
+        }
+    });
+}
@@ -0,0 +1,15 @@
+#include "parallel.h"
+#include <cstdio>
+#include <atomic>
+int main(){
+  parallel::ThreadPool pool(2);
+  long bad=0;
+  for (int iter=0; iter<50; iter++){
+    std::atomic<int> a{0}, b{0};
+    { std::function<void(size_t)> fa = [&](size_t){ a++; }; pool.run(3, fa); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(7));
+    { std::function<void(size_t)> fb = [&](size_t){ b++; }; pool.run(5, fb); }
+    if (a != 3 || b != 5) { bad++; if (bad < 5) printf("iter %d a=%d b=%d\n", iter, a.load(), b.load()); }
+  }
+  printf("bad=%ld\n", bad);
+}